@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * Sketch that works with whatever is plugged in, be it a N64 controller or
+ * mouse, a GC controller, WaveBird or keyboard, reporting what it is and then
+ * continuously dumping its normalized state.
+ *
+ * See the N64PadDump and GCPadDump examples for wiring.
+ */
+
+#include <AutoPad.h>
+
+AutoPad pad;
+
+const char * const typeNames[AutoPad::DEV_NUMBER] = {
+	"Nothing",
+	"N64 controller",
+	"N64 mouse",
+	"GC controller",
+	"WaveBird",
+	"GC keyboard"
+};
+
+const char * const buttonNames[16] = {
+	"A", "B", "X", "Y", "Z", "Start", "L", "R",
+	"Up", "Down", "Left", "Right", "C-Up", "C-Down", "C-Left", "C-Right"
+};
+
+void setup () {
+	Serial.begin (115200);
+
+	pinMode (LED_BUILTIN, OUTPUT);
+}
+
+void loop () {
+	// Keep probing until something is connected, also after it is unplugged
+	if (pad.type == AutoPad::DEV_NONE || !pad.read ()) {
+		Serial.println ("Probing for device...");
+		pad.begin ();
+		Serial.print ("Detected: ");
+		Serial.println (typeNames[pad.type]);
+		delay (500);
+		return;
+	}
+
+	const AutoPadState& s = pad.state;
+
+	digitalWrite (LED_BUILTIN, s.buttons != 0);
+
+	Serial.print ("Pressed: ");
+	for (byte i = 0; i < 16; ++i) {
+		if (s.buttons & (1U << i)) {
+			Serial.print (buttonNames[i]);
+			Serial.print (' ');
+		}
+	}
+	Serial.println ();
+
+	Serial.print ("Stick = ");
+	Serial.print (s.x);
+	Serial.print (", ");
+	Serial.println (s.y);
+
+	Serial.print ("C-Stick = ");
+	Serial.print (s.c_x);
+	Serial.print (", ");
+	Serial.println (s.c_y);
+
+	Serial.print ("Triggers = ");
+	Serial.print (s.left_trigger);
+	Serial.print (", ");
+	Serial.println (s.right_trigger);
+
+	Serial.print ("Keys = ");
+	for (byte i = 0; i < 3; ++i) {
+		Serial.print (s.keys[i], HEX);
+		Serial.print (' ');
+	}
+	Serial.println ();
+
+	Serial.println ();
+
+	delay (1000);
+}
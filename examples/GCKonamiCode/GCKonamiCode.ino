@@ -29,14 +29,10 @@ GCPad pad;
 void setup () {
 	Serial.begin (115200);
 
-	Serial.println ("Probing for pad...");
-	if (pad.begin ()) {
-		Serial.println ("Pad detected");
-	}
-	delay (500);
-
 	pinMode (LED_BUILTIN, OUTPUT);
 
+	Serial.println ("Probing for pad...");
+
 	Serial.println ("Enter the Konami code on your pad (Up, up, down, down, left, right, left, right, B, A)");
 }
 
@@ -56,9 +52,27 @@ word konami_seq[KONAMI_SEQ_LEN] = {
 };
 
 void loop () {
+	static boolean haveController = false;
 	static byte konami_cnt = 0;
 
-	pad.read ();
+	// Keep trying, so that the pad can be plugged in anytime
+	if (!haveController) {
+		if (pad.begin ()) {
+			Serial.println ("Pad detected");
+			haveController = true;
+		} else {
+			delay (333);
+		}
+		return;
+	}
+
+	if (!pad.read ()) {
+		Serial.println ("Pad lost");
+		digitalWrite (LED_BUILTIN, LOW);
+		haveController = false;
+		konami_cnt = 0;
+		return;
+	}
 
 	digitalWrite (LED_BUILTIN, pad.buttons != 0);
 
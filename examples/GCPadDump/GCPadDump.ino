@@ -58,18 +58,32 @@ GCPad pad;
 void setup () {
 	Serial.begin (115200);
 
-	Serial.println ("Probing for pad...");
-	if (pad.begin ()) {
-		Serial.println ("Pad detected");
-	}
-	delay (500);
-
 	pinMode (LED_BUILTIN, OUTPUT);
+
+	Serial.println ("Probing for pad...");
 }
 
 
 void loop () {
-	pad.read ();
+	static boolean haveController = false;
+
+	// Keep trying, so that the pad can be plugged in anytime
+	if (!haveController) {
+		if (pad.begin ()) {
+			Serial.println ("Pad detected");
+			haveController = true;
+		} else {
+			delay (333);
+		}
+		return;
+	}
+
+	if (!pad.read ()) {
+		Serial.println ("Pad lost");
+		digitalWrite (LED_BUILTIN, LOW);
+		haveController = false;
+		return;
+	}
 
 	digitalWrite (LED_BUILTIN, pad.buttons != 0);
 
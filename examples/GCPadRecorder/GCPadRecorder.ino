@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * Sketch that records everything done with a GC controller, so that it can be
+ * replayed later, either by the GCPadReplay example or on a PC with the
+ * extras/n64trace.py tool.
+ *
+ * By default the trace is sent in binary form over the serial port, save it
+ * with:
+ *
+ *   n64trace.py capture /dev/ttyACM0 trace.bin
+ *
+ * If RECORD_TO_EEPROM is defined below, it is saved to the EEPROM instead, for
+ * when no PC is around. That is only good for a few minutes of play and EEPROM
+ * writes take 3.3 ms per byte, so polls might be late when lots of things
+ * change at once.
+ *
+ * Recording stops when Start is held together with both L and R.
+ *
+ * See GCPadDump for wiring.
+ */
+
+#include <GCPad.h>
+#include <InputRecorder.h>
+
+//~ #define RECORD_TO_EEPROM
+
+// Time between polls, which is also used when replaying
+const byte POLL_PERIOD_MS = 10;
+
+// Largest possible record plus end of trace
+const byte MAX_RECORD_SIZE = 1 + GC_FRAME_SIZE + 2 + 2;
+
+GCPad pad;
+
+byte ringBuffer[64];
+InputRecorder recorder (ringBuffer, sizeof (ringBuffer));
+
+#ifdef RECORD_TO_EEPROM
+EepromStream eeprom;
+#endif
+
+boolean recording = false;
+
+void setup () {
+	Serial.begin (115200);
+	pinMode (LED_BUILTIN, OUTPUT);
+
+	// Polls are scheduled below, at exactly the rate they will be replayed at
+	pad.pollInterval = 0;
+
+	while (!pad.begin ())
+		delay (333);
+
+#ifdef RECORD_TO_EEPROM
+	recorder.begin (eeprom, GC_FRAME_SIZE, POLL_PERIOD_MS);
+#else
+	recorder.begin (Serial, GC_FRAME_SIZE, POLL_PERIOD_MS);
+#endif
+
+	recording = true;
+	digitalWrite (LED_BUILTIN, HIGH);
+}
+
+void loop () {
+	static unsigned long lastPoll = 0;
+
+	if (recording && millis () - lastPoll >= POLL_PERIOD_MS) {
+		lastPoll += POLL_PERIOD_MS;
+
+		/* A failed read keeps the previous state, so that the timeline stays
+		 * the same
+		 */
+		pad.read ();
+
+		byte frame[GC_FRAME_SIZE];
+		packFrame (pad, frame);
+		recorder.record (frame);
+
+		// Nothing else to do until the next poll
+		recorder.flush ();
+
+		const uint16_t stopCombo = GCPad::BTN_START | GCPad::BTN_L | GCPad::BTN_R;
+		boolean stop = (pad.buttons & stopCombo) == stopCombo;
+#ifdef RECORD_TO_EEPROM
+		stop = stop || recorder.traceBytes + MAX_RECORD_SIZE > E2END + 1UL;
+#endif
+		if (stop) {
+			recorder.end ();
+			recording = false;
+			digitalWrite (LED_BUILTIN, LOW);
+		}
+	}
+}
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * Sketch that replays a trace saved to the EEPROM by the GCPadRecorder example,
+ * printing what the controller state was at every poll, at the same rate it
+ * was recorded.
+ *
+ * The state is put in a GCPad object, just like read() would, so any code
+ * using it can be tested with the recorded input instead of a real controller.
+ */
+
+#include <GCPad.h>
+#include <InputRecorder.h>
+
+GCPad pad;
+
+EepromStream eeprom;
+InputReplay replay;
+
+void setup () {
+	Serial.begin (115200);
+	while (!Serial)
+		;
+
+	if (!replay.begin (eeprom) || replay.frameSize != GC_FRAME_SIZE) {
+		Serial.println (F("No GC trace in EEPROM"));
+		while (42)
+			;
+	}
+
+	Serial.print (F("Replaying, poll period is "));
+	Serial.print (replay.periodMs);
+	Serial.println (F(" ms"));
+}
+
+void loop () {
+	static unsigned long lastPoll = millis ();
+	static unsigned long polls = 0;
+
+	if (millis () - lastPoll >= replay.periodMs) {
+		lastPoll += replay.periodMs;
+
+		byte frame[GC_FRAME_SIZE];
+		if (replay.next (frame)) {
+			unpackFrame (frame, pad);
+
+			// Use pad as if it had just been read()
+
+			Serial.print (polls * replay.periodMs);
+			Serial.print (F(" ms: Buttons = "));
+			Serial.print (pad.buttons, HEX);
+			Serial.print (F(", Stick = "));
+			Serial.print (pad.x);
+			Serial.print (',');
+			Serial.print (pad.y);
+			Serial.print (F(", C-Stick = "));
+			Serial.print (pad.c_x);
+			Serial.print (',');
+			Serial.print (pad.c_y);
+			Serial.print (F(", Triggers = "));
+			Serial.print (pad.left_trigger);
+			Serial.print (',');
+			Serial.println (pad.right_trigger);
+
+			++polls;
+		} else if (replay.finished ()) {
+			Serial.println (F("Replay finished"));
+
+			// Start over
+			eeprom.rewind ();
+			replay.begin (eeprom);
+			polls = 0;
+		}
+	}
+}
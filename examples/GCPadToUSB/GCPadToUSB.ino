@@ -28,6 +28,20 @@
 #include <GCPad.h>
 #include <Joystick.h>
 
+/* Enable this to measure the input latency of this sketch. Start will be
+ * pressed and released at random times and the latency figures will be printed
+ * on the serial port every REPORT_TRIALS trials.
+ */
+//~ #define MEASURE_LATENCY
+
+#ifdef MEASURE_LATENCY
+#include <LatencyProbe.h>
+
+const unsigned long REPORT_TRIALS = 1000;
+
+LatencyProbe probe;
+#endif
+
 
 /** \brief Dead zone for analog sticks
  *
@@ -139,24 +153,11 @@ bool mapLeftStickToDPad = false;
 #define deadify(var, thres) (abs (var) > thres ? (var) : 0)
 
 
-void setup () {
-	pinMode (LED_BUILTIN, OUTPUT);
-
-	if (!pad.begin ()) {
-		// Report error, somehow
-		while (1) {
-			digitalWrite (LED_BUILTIN, HIGH);
-			delay (300);
-			digitalWrite (LED_BUILTIN, LOW);
-			delay (700);
-		}
-	}
-
-	// Check for button A
+// Holding A when the controller is detected maps the left stick to the D-Pad
+void checkDPadMapping () {
 	pad.read ();
-	if ((pad.buttons & GCPad::BTN_A) != 0) {
-		mapLeftStickToDPad = true;
-
+	mapLeftStickToDPad = (pad.buttons & GCPad::BTN_A) != 0;
+	if (mapLeftStickToDPad) {
 		// Signal we got it!
 		digitalWrite (LED_BUILTIN, HIGH);
 		delay (200);
@@ -169,6 +170,10 @@ void setup () {
 		digitalWrite (LED_BUILTIN, HIGH);
 		delay (1000);
 	}
+}
+
+void setup () {
+	pinMode (LED_BUILTIN, OUTPUT);
 
 	// Init Joystick library
 	usbStick.begin (false);		// We'll call sendState() manually to minimize lag
@@ -178,13 +183,45 @@ void setup () {
 	usbStick.setRyAxisRange (ANALOG_MAX_VALUE, ANALOG_MIN_VALUE);		// Analog is positive UP on controller, DOWN in joystick library
 	usbStick.setAcceleratorRange (0, 260);
 	usbStick.setBrakeRange (0, 260);
+
+#ifdef MEASURE_LATENCY
+	Serial.begin (115200);
+	probe.begin (GCPad::BTN_START, 100000UL);
+#endif
 }
 
 // Value axes report when centered
 #define CENTER_POS 127
 
 void loop () {
-	pad.read ();
+	static boolean haveController = false;
+
+	if (!haveController) {
+		if (pad.begin ()) {
+			// Controller detected!
+			checkDPadMapping ();
+			haveController = true;
+		} else {
+			delay (333);
+		}
+		return;
+	}
+
+#ifdef MEASURE_LATENCY
+	if (pad.timeToNextPoll () == 0)
+		probe.sample ();
+#endif
+	if (!pad.read ()) {
+		// Controller lost :(
+		digitalWrite (LED_BUILTIN, LOW);
+		haveController = false;
+		return;
+	}
+
+	// Controller was read fine, only this can complete a latency trial
+#ifdef MEASURE_LATENCY
+	probe.apply (pad.buttons);
+#endif
 
 	digitalWrite (LED_BUILTIN, pad.buttons != 0);
 
@@ -266,4 +303,9 @@ void loop () {
 
 	// All done, send data for real!
 	usbStick.sendState ();
+
+#ifdef MEASURE_LATENCY
+	if (probe.output () && probe.trials % REPORT_TRIALS == 0)
+		probe.report (Serial);
+#endif
 }
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * Sketch that measures how long InputRecorder takes per poll and how well it
+ * compresses, so that it can be judged whether it fits in the time left
+ * between polls.
+ *
+ * No controller is needed: input is simulated, with sticks drifting slowly and
+ * buttons being pressed now and then, roughly like a real game session at a
+ * 10 ms poll period. Expect the ratio to be worse with real sticks, which never
+ * stay completely still. Use "n64trace.py stats" on real traces.
+ */
+
+#include <InputRecorder.h>
+
+const unsigned int POLLS = 6000;		// 1 minute at 10 ms
+
+// Discards the trace, we only want to time the recorder
+class NullPrint: public Print {
+public:
+	virtual size_t write (uint8_t b) {
+		(void) b;
+		return 1;
+	}
+
+	virtual size_t write (const uint8_t *buffer, size_t size) {
+		(void) buffer;
+		return size;
+	}
+};
+
+NullPrint nullPrint;
+
+byte ringBuffer[64];
+InputRecorder recorder (ringBuffer, sizeof (ringBuffer));
+
+// Next simulated state, in the same layout as packFrame (GCPad)
+void simulate (byte *frame) {
+	// Sticks and triggers: hold still most of the time, then move for a while
+	static byte moving = 0;
+	if (moving > 0) {
+		--moving;
+		byte field = 2 + random (6);
+		frame[field] += random (-3, 4);
+	} else if (random (100) == 0) {
+		moving = random (5, 50);
+	}
+
+	// Buttons: a press or release every half second or so
+	if (random (50) == 0)
+		frame[1] ^= 1 << random (8);
+}
+
+void setup () {
+	Serial.begin (115200);
+	while (!Serial)
+		;
+
+	randomSeed (42);
+}
+
+void loop () {
+	byte frame[GC_FRAME_SIZE] = {0x00, 0x80, 128, 128, 128, 128, 0, 0};
+
+	unsigned long recMin = 0xFFFFFFFFUL, recMax = 0, recTotal = 0;
+	unsigned long flushMax = 0;
+
+	recorder.begin (nullPrint, GC_FRAME_SIZE, 10);
+	for (unsigned int i = 0; i < POLLS; ++i) {
+		simulate (frame);
+
+		unsigned long start = micros ();
+		recorder.record (frame);
+		unsigned long t = micros () - start;
+		recMin = min (recMin, t);
+		recMax = max (recMax, t);
+		recTotal += t;
+
+		start = micros ();
+		recorder.flush ();
+		flushMax = max (flushMax, micros () - start);
+	}
+	recorder.end ();
+
+	unsigned long raw = (unsigned long) POLLS * GC_FRAME_SIZE;
+
+	Serial.print (F("Polls: "));
+	Serial.println (recorder.polls);
+	Serial.print (F("Raw bytes: "));
+	Serial.println (raw);
+	Serial.print (F("Trace bytes: "));
+	Serial.println (recorder.traceBytes);
+	Serial.print (F("Ratio: "));
+	Serial.print ((float) raw / recorder.traceBytes);
+	Serial.println (F(":1"));
+	Serial.print (F("record() us min/avg/max: "));
+	Serial.print (recMin);
+	Serial.print ('/');
+	Serial.print ((float) recTotal / POLLS);
+	Serial.print ('/');
+	Serial.println (recMax);
+	Serial.print (F("flush() us max: "));
+	Serial.println (flushMax);
+	Serial.println ();
+
+	delay (5000);
+}
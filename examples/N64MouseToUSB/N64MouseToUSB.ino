@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * This sketch turns a N64 mouse into an USB one, using the Mouse library that
+ * comes with the Arduino IDE, on a Leonardo or Micro.
+ *
+ * The mouse is polled as fast as possible, while reports are only sent as often
+ * as the host asks for them. Any movement in between is added up and sent with
+ * the next report, so none is lost even on fast swipes.
+ */
+
+#include <N64Mouse.h>
+#include <Mouse.h>
+
+/** \brief Time between two USB reports
+ *
+ * The Arduino HID endpoint asks the host to be polled every 1 ms. Sending
+ * faster than that would just block until the previous report is taken.
+ */
+const unsigned long REPORT_INTERVAL_US = 1000UL;
+
+N64Mouse mouse;
+
+void setup () {
+	pinMode (LED_BUILTIN, OUTPUT);
+
+	Mouse.begin ();
+}
+
+void loop () {
+	static boolean haveMouse = false;
+	static uint16_t oldButtons = 0;
+	static unsigned long lastReport = 0;
+
+	if (!haveMouse) {
+		if (mouse.begin ()) {
+			// Mouse detected!
+			digitalWrite (LED_BUILTIN, HIGH);
+			haveMouse = true;
+		} else {
+			delay (333);
+		}
+	} else if (!mouse.read ()) {
+		// Mouse lost :(
+		digitalWrite (LED_BUILTIN, LOW);
+		Mouse.release (MOUSE_LEFT | MOUSE_RIGHT);
+		oldButtons = 0;
+		haveMouse = false;
+	} else {
+		// Buttons are sent as soon as they change
+		uint16_t changed = mouse.buttons ^ oldButtons;
+		if (changed & N64Mouse::BTN_LEFT) {
+			if (mouse.buttons & N64Mouse::BTN_LEFT)
+				Mouse.press (MOUSE_LEFT);
+			else
+				Mouse.release (MOUSE_LEFT);
+		}
+		if (changed & N64Mouse::BTN_RIGHT) {
+			if (mouse.buttons & N64Mouse::BTN_RIGHT)
+				Mouse.press (MOUSE_RIGHT);
+			else
+				Mouse.release (MOUSE_RIGHT);
+		}
+		oldButtons = mouse.buttons;
+
+		// Movement, at most once per host poll
+		if (mouse.moved () && micros () - lastReport >= REPORT_INTERVAL_US) {
+			int8_t x, y;
+			mouse.drain (x, y);
+			Mouse.move (x, -y, 0);		// Y is positive DOWN for USB
+			lastReport = micros ();
+		}
+	}
+}
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * Sketch that polls the controller as fast as possible and reports how long a
+ * poll takes (min/avg/max), how many fail and how many had to be retried
+ * because of a glitch (see retries and corruptFrames). Build it once with the
+ * default ISR receiver and once with N64PAD_POLLING_RECEIVER enabled in
+ * pinconfig.h to compare them on your board.
+ *
+ * It also measures how late a Timer 2 interrupt, which is set to fire every
+ * 128 us, gets served at most, to show how much a poll gets in the way of other
+ * ISRs. Delays up to 510 us can be measured, which is longer than interrupts
+ * are ever disabled during a poll. Conversely, with the ISR receiver, that
+ * interrupt might make some polls fail. This only works on boards with Timer 2
+ * (i.e.: not on the Leonardo).
+ *
+ * The controller is connected as in the N64PadDump example.
+ */
+
+#include <N64Pad.h>
+#include <protocol/pinconfig.h>		// Just to know what receiver is in use
+
+// Number of polls per report
+const unsigned int N_POLLS = 1000;
+
+N64Pad pad;
+
+#ifdef TCNT2
+volatile byte maxIsrDelay = 0;
+
+// Ticks between two interrupts
+const byte ISR_PERIOD = 64;
+
+ISR (TIMER2_COMPA_vect) {
+	/* The timer runs freely and OCR2A is when we should have been called, so
+	 * this is how late we are, even past the next period
+	 */
+	byte d = TCNT2 - OCR2A;
+	if (d > maxIsrDelay)
+		maxIsrDelay = d;
+
+	// Skip the periods we missed, or we'd only be called again after a wrap
+	OCR2A += (d / ISR_PERIOD + 1) * ISR_PERIOD;
+}
+#endif
+
+void setup () {
+	Serial.begin (115200);
+	while (!Serial)
+		;
+
+	// We'll be polling as fast as we can
+	pad.pollInterval = 0;
+
+#ifdef TCNT2
+	// Normal mode, prescaler = 32 (2 us per tick at 16 MHz), wraps every 512 us
+	TCCR2A = 0;
+	TCCR2B = (1 << CS21) | (1 << CS20);
+	OCR2A = TCNT2 + ISR_PERIOD;
+	TIFR2 = (1 << OCF2A);
+	TIMSK2 = (1 << OCIE2A);
+#endif
+
+#ifdef N64PAD_POLLING_RECEIVER
+	Serial.println (F("Receiver: polling"));
+#else
+	Serial.println (F("Receiver: ISR"));
+#endif
+}
+
+void loop () {
+	if (!pad.begin ()) {
+		Serial.println (F("No controller"));
+		delay (1000);
+		return;
+	}
+
+	unsigned long minUs = 0xFFFFFFFFUL, maxUs = 0, totUs = 0;
+	unsigned int failed = 0;
+	unsigned int retries = pad.retries;
+	unsigned int corrupt = pad.corruptFrames;
+
+#ifdef TCNT2
+	maxIsrDelay = 0;
+#endif
+
+	for (unsigned int i = 0; i < N_POLLS; ++i) {
+		unsigned long start = micros ();
+		boolean ok = pad.read ();
+		unsigned long t = micros () - start;
+
+		if (!ok) {
+			++failed;
+		} else {
+			totUs += t;
+			if (t < minUs)
+				minUs = t;
+			if (t > maxUs)
+				maxUs = t;
+		}
+
+		// Give the controller a break
+		delayMicroseconds (500);
+	}
+
+	Serial.print (F("Poll time (us): min "));
+	Serial.print (minUs);
+	Serial.print (F(", avg "));
+	Serial.print (failed < N_POLLS ? totUs / (N_POLLS - failed) : 0);
+	Serial.print (F(", max "));
+	Serial.print (maxUs);
+	Serial.print (F(" - Failed: "));
+	Serial.print (failed);
+	Serial.print ('/');
+	Serial.print (N_POLLS);
+	Serial.print (F(" - Retried: "));
+	Serial.print (pad.retries - retries);
+	Serial.print (F(", corrupt: "));
+	Serial.print (pad.corruptFrames - corrupt);
+#ifdef TCNT2
+	Serial.print (F(" - Max ISR delay (us): "));
+	Serial.print (maxIsrDelay * 2);
+#endif
+	Serial.println ();
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * Sketch that shows how to save power between controller polls, as you would
+ * do in a battery-powered adapter. The controller is polled every
+ * POLL_INTERVAL_MS and the CPU sleeps in between. Every now and then, the
+ * figures needed to estimate the current drawn per poll are printed.
+ *
+ * The controller is connected as in the N64PadDump example.
+ */
+
+#include <N64Pad.h>
+#include <N64PadPower.h>
+
+// Some wireless links are happy with fewer updates than the 60 Hz default
+const byte POLL_INTERVAL_MS = 32;
+
+// Print stats every this many polls
+const unsigned int STATS_INTERVAL = 100;
+
+N64Pad pad;
+
+unsigned long totActiveUs = 0;
+unsigned long totAsleepMs = 0;
+unsigned long totIdleMs = 0;
+unsigned int maxWakeUs = 0;
+unsigned int nStats = 0;
+
+void powerHook (const N64PadPowerStats& stats) {
+	totActiveUs += stats.activeUs;
+	totAsleepMs += stats.asleepMs;
+	totIdleMs += stats.idleMs;
+	if (stats.wakeUs > maxWakeUs)
+		maxWakeUs = stats.wakeUs;
+	++nStats;
+}
+
+void setup () {
+	Serial.begin (115200);
+	while (!Serial)
+		;
+
+	pad.pollInterval = POLL_INTERVAL_MS;
+	N64PadPower::setHook (powerHook);
+
+	Serial.println ("Ready!");
+}
+
+void loop () {
+	static boolean haveController = false;
+
+	if (!haveController) {
+		if (pad.begin ()) {
+			Serial.println (F("Controller found!"));
+			haveController = true;
+		}
+	} else if (!pad.read ()) {
+		Serial.println (F("Controller lost :("));
+		haveController = false;
+	}
+
+	if (nStats >= STATS_INTERVAL) {
+		Serial.print (F("Per poll: active "));
+		Serial.print (totActiveUs / nStats);
+		Serial.print (F(" us, power-down "));
+		Serial.print (totAsleepMs / nStats);
+		Serial.print (F(" ms, idle "));
+		Serial.print (totIdleMs / nStats);
+		Serial.print (F(" ms - Max wake latency "));
+		Serial.print (maxWakeUs);
+		Serial.println (F(" us"));
+
+		totActiveUs = 0;
+		totAsleepMs = 0;
+		totIdleMs = 0;
+		maxWakeUs = 0;
+		nStats = 0;
+	}
+
+	// Serial stops in power-down, make sure everything is out
+	Serial.flush ();
+
+	N64PadPower::sleep (haveController ? pad.timeToNextPoll () : 333);
+}
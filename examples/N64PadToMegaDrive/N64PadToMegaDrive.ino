@@ -103,6 +103,20 @@
 
 #include <N64Pad.h>
 
+/* Enable this to measure the input latency of this sketch. Start will be
+ * pressed and released at random times and the latency figures will be printed
+ * on the serial port every REPORT_TRIALS trials.
+ */
+//~ #define MEASURE_LATENCY
+
+#ifdef MEASURE_LATENCY
+#include <LatencyProbe.h>
+
+const unsigned long REPORT_TRIALS = 1000;
+
+LatencyProbe probe;
+#endif
+
 /* These are the offsets that the analog stick must move before we trigger the
  * corresponding directional button
  *
@@ -133,12 +147,24 @@ void setup () {
 	DDRD |= ((1 << DDD2) | (1 << DDD3) | (1 << DDD4) | (1 << DDD5));
 	DDRB |= ((1 << DDB2) | (1 << DDB3) | (1 << DDB4) | (1 << DDB5));
 	DDRB |= ((1 << DDB1) | (1 << DDB0));
+
+#ifdef MEASURE_LATENCY
+	Serial.begin (115200);
+	probe.begin (N64Pad::BTN_START, 100000UL);
+#endif
 }
 
 
 // Update as fast as we can
 void loop () {
+#ifdef MEASURE_LATENCY
+	if (pad.timeToNextPoll () == 0)
+		probe.sample ();
+#endif
 	pad.read ();
+#ifdef MEASURE_LATENCY
+	probe.apply (pad.buttons);
+#endif
 
 	/* To understand this, keep in mind that the MegaDrive uses the LOW state to
 	 * indicate that a button is pressed, and review De Morgan's laws
@@ -164,4 +190,9 @@ void loop () {
 		  
 	// Blink led with buttons
 	digitalWrite (LED_PIN, pad.buttons != 0);
+
+#ifdef MEASURE_LATENCY
+	if (probe.output () && probe.trials % REPORT_TRIALS == 0)
+		probe.report (Serial);
+#endif
 }
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * This sketch turns a N64 controller into a MegaDrive/Genesis 6-button one,
+ * using a single Arduino Uno/Nano/Pro Mini and no other components. See the
+ * N64PadToMegaDrive sketch for a version using an external multiplexer.
+ *
+ * Button mappings:
+ * - A and B are mapped to... A and B
+ * - Z and R are mapped to C
+ * - C-Left, C-Up and C-Right are mapped to X, Y and Z
+ * - L is mapped to Mode
+ * - Start is mapped to... well, Start
+ * - The analog stick and the D-Pad are mapped to the directional buttons
+ *
+ * Connections:
+ * - Arduino Pin 2 -> MegaDrive Pad Port Pin 7
+ * - Arduino Pin 8 -> MegaDrive Pad Port Pin 1
+ * - Arduino Pin 9 -> MegaDrive Pad Port Pin 2
+ * - Arduino Pin 10 -> MegaDrive Pad Port Pin 3
+ * - Arduino Pin 11 -> MegaDrive Pad Port Pin 4
+ * - Arduino Pin 12 -> MegaDrive Pad Port Pin 6
+ * - Arduino Pin 13 -> MegaDrive Pad Port Pin 9
+ * - Arduino GND -> MegaDrive Pad Port Pin 8
+ * - (Optional) Pin A5 goes to a LED + series resistor that will light up when
+ *   buttons are pressed.
+ *
+ * The controller goes to pin 3 as usual.
+ *
+ * Note that millis() and delay() cannot be used together with MegaDriveOutput,
+ * see MegaDriveOutput.h for details.
+ */
+
+#include <N64Pad.h>
+#include <MegaDriveOutput.h>
+
+/* These are the offsets that the analog stick must move before we trigger the
+ * corresponding directional button
+ *
+ * 20 means about a quarter, feels fine to me
+ */
+#define MIN_X_OFFSET 20
+#define MIN_Y_OFFSET MIN_X_OFFSET
+
+// Pin 13 is an output to the MegaDrive
+#define LED_PIN A5
+
+N64Pad pad;
+MegaDriveOutput md;
+
+void setup () {
+	pinMode (LED_PIN, OUTPUT);
+
+	// Polls are scheduled by md.canPoll()
+	pad.pollInterval = 0;
+
+	md.begin ();
+}
+
+void loop () {
+	static boolean haveController = false;
+
+	// Only talk to the controller when the console is not reading the pad
+	if (md.canPoll ()) {
+		if (!haveController) {
+			haveController = pad.begin ();
+		} else if (!pad.read ()) {
+			// Controller lost :(
+			haveController = false;
+			pad.buttons = 0;
+			pad.x = 0;
+			pad.y = 0;
+		}
+
+		uint16_t buttons = 0;
+		if ((pad.buttons & N64Pad::BTN_UP) || pad.y > MIN_Y_OFFSET)
+			buttons |= MegaDriveOutput::MD_UP;
+		if ((pad.buttons & N64Pad::BTN_DOWN) || pad.y < -MIN_Y_OFFSET)
+			buttons |= MegaDriveOutput::MD_DOWN;
+		if ((pad.buttons & N64Pad::BTN_LEFT) || pad.x < -MIN_X_OFFSET)
+			buttons |= MegaDriveOutput::MD_LEFT;
+		if ((pad.buttons & N64Pad::BTN_RIGHT) || pad.x > MIN_X_OFFSET)
+			buttons |= MegaDriveOutput::MD_RIGHT;
+		if (pad.buttons & N64Pad::BTN_A)
+			buttons |= MegaDriveOutput::MD_A;
+		if (pad.buttons & N64Pad::BTN_B)
+			buttons |= MegaDriveOutput::MD_B;
+		if (pad.buttons & (N64Pad::BTN_Z | N64Pad::BTN_R))
+			buttons |= MegaDriveOutput::MD_C;
+		if (pad.buttons & N64Pad::BTN_START)
+			buttons |= MegaDriveOutput::MD_START;
+		if (pad.buttons & N64Pad::BTN_C_LEFT)
+			buttons |= MegaDriveOutput::MD_X;
+		if (pad.buttons & N64Pad::BTN_C_UP)
+			buttons |= MegaDriveOutput::MD_Y;
+		if (pad.buttons & N64Pad::BTN_C_RIGHT)
+			buttons |= MegaDriveOutput::MD_Z;
+		if (pad.buttons & N64Pad::BTN_L)
+			buttons |= MegaDriveOutput::MD_MODE;
+
+		md.setButtons (buttons);
+
+		// Light led with buttons
+		digitalWrite (LED_PIN, buttons != 0);
+	}
+}
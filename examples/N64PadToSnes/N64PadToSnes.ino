@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * This sketch turns a N64 controller into a SNES one (or a NES one, see
+ * NES_MODE below), using a single Arduino Uno/Nano/Pro Mini.
+ *
+ * Button mappings:
+ * - A is mapped to B, B is mapped to Y
+ * - C-Down and C-Right are mapped to A
+ * - C-Up and C-Left are mapped to X
+ * - Z is mapped to L, R is mapped to R
+ * - L is mapped to Select
+ * - Start is mapped to... well, Start
+ * - The analog stick and the D-Pad are mapped to the directional buttons
+ *
+ * In NES mode, the SNES B and Y buttons become NES A and B.
+ *
+ * Connections:
+ * - Arduino Pin 2 -> SNES Pad Port Pin 3 (Latch)
+ * - Arduino Pin 10 -> SNES Pad Port Pin 3 (Latch, again)
+ * - Arduino Pin 12 -> SNES Pad Port Pin 4 (Data)
+ * - Arduino Pin 13 -> SNES Pad Port Pin 2 (Clock)
+ * - Arduino GND -> SNES Pad Port Pin 7
+ *
+ * The controller goes to pin 3 as usual.
+ */
+
+#include <N64Pad.h>
+#include <SnesOutput.h>
+
+// Set to true to act as a NES controller
+#define NES_MODE false
+
+/* These are the offsets that the analog stick must move before we trigger the
+ * corresponding directional button
+ *
+ * 20 means about a quarter, feels fine to me
+ */
+#define MIN_X_OFFSET 20
+#define MIN_Y_OFFSET MIN_X_OFFSET
+
+N64Pad pad;
+SnesOutput snes;
+
+void setup () {
+	// Polls are scheduled by snes.canPoll()
+	pad.pollInterval = 0;
+
+	snes.begin (NES_MODE);
+}
+
+void loop () {
+	static boolean haveController = false;
+
+	// Only talk to the controller when the console is not reading the pad
+	if (snes.canPoll ()) {
+		if (!haveController) {
+			haveController = pad.begin ();
+		} else if (!pad.read ()) {
+			// Controller lost :(
+			haveController = false;
+			pad.buttons = 0;
+			pad.x = 0;
+			pad.y = 0;
+		}
+
+		uint16_t buttons = 0;
+		if ((pad.buttons & N64Pad::BTN_UP) || pad.y > MIN_Y_OFFSET)
+			buttons |= SnesOutput::SNES_UP;
+		if ((pad.buttons & N64Pad::BTN_DOWN) || pad.y < -MIN_Y_OFFSET)
+			buttons |= SnesOutput::SNES_DOWN;
+		if ((pad.buttons & N64Pad::BTN_LEFT) || pad.x < -MIN_X_OFFSET)
+			buttons |= SnesOutput::SNES_LEFT;
+		if ((pad.buttons & N64Pad::BTN_RIGHT) || pad.x > MIN_X_OFFSET)
+			buttons |= SnesOutput::SNES_RIGHT;
+		if (pad.buttons & N64Pad::BTN_A)
+			buttons |= NES_MODE ? SnesOutput::SNES_A : SnesOutput::SNES_B;
+		if (pad.buttons & N64Pad::BTN_B)
+			buttons |= NES_MODE ? SnesOutput::SNES_B : SnesOutput::SNES_Y;
+		if (pad.buttons & (N64Pad::BTN_C_DOWN | N64Pad::BTN_C_RIGHT))
+			buttons |= SnesOutput::SNES_A;
+		if (pad.buttons & (N64Pad::BTN_C_UP | N64Pad::BTN_C_LEFT))
+			buttons |= SnesOutput::SNES_X;
+		if (pad.buttons & N64Pad::BTN_Z)
+			buttons |= SnesOutput::SNES_L;
+		if (pad.buttons & N64Pad::BTN_R)
+			buttons |= SnesOutput::SNES_R;
+		if (pad.buttons & N64Pad::BTN_L)
+			buttons |= SnesOutput::SNES_SELECT;
+		if (pad.buttons & N64Pad::BTN_START)
+			buttons |= SnesOutput::SNES_START;
+
+		snes.setButtons (buttons);
+	}
+}
@@ -28,6 +28,20 @@
 #include <N64Pad.h>
 #include <Joystick.h>
 
+/* Enable this to measure the input latency of this sketch. Start will be
+ * pressed and released at random times and the latency figures will be printed
+ * on the serial port every REPORT_TRIALS trials.
+ */
+//~ #define MEASURE_LATENCY
+
+#ifdef MEASURE_LATENCY
+#include <LatencyProbe.h>
+
+const unsigned long REPORT_TRIALS = 1000;
+
+LatencyProbe probe;
+#endif
+
 /** \brief Dead zone for analog sticks
  *
  * If the analog stick moves less than this value from the center position, it
@@ -119,6 +133,11 @@ void setup () {
 	usbStick.setYAxisRange (ANALOG_MIN_VALUE, ANALOG_MAX_VALUE);
 	usbStick.setRxAxisRange (ANALOG_MIN_VALUE, ANALOG_MAX_VALUE);
 	usbStick.setRyAxisRange (ANALOG_MAX_VALUE, ANALOG_MIN_VALUE);		// Analog is positive UP on controller, DOWN in joystick library
+
+#ifdef MEASURE_LATENCY
+	Serial.begin (115200);
+	probe.begin (N64Pad::BTN_START, 100000UL);
+#endif
 }
 
 
@@ -134,12 +153,19 @@ void loop () {
 				delay (333);
 		}
 	} else {
+#ifdef MEASURE_LATENCY
+		if (pad.timeToNextPoll () == 0)
+			probe.sample ();
+#endif
 		if (!pad.read ()) {
 			// Controller lost :(
 			digitalWrite (LED_BUILTIN, LOW);
 			haveController = false;
 		} else {
 			// Controller was read fine
+#ifdef MEASURE_LATENCY
+			probe.apply (pad.buttons);
+#endif
 			if ((pad.buttons & N64Pad::BTN_LRSTART) != 0) {
 				// This combo toggles mapAnalogToDPad
 				mapAnalogToDPad = !mapAnalogToDPad;
@@ -199,6 +225,11 @@ void loop () {
 
 				// All done, send data for real!
 				usbStick.sendState ();
+
+#ifdef MEASURE_LATENCY
+				if (probe.output () && probe.trials % REPORT_TRIALS == 0)
+					probe.report (Serial);
+#endif
 			}
 		}
 	}
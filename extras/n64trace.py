@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+#
+# This file is part of N64Pad for Arduino.
+#
+# Copyright (C) 2015-2021 by SukkoPera
+#
+# N64Pad is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# N64Pad is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with N64Pad. If not, see <http://www.gnu.org/licenses/>.
+
+"""Encodes and decodes the controller input traces of InputRecorder.
+
+Traces are converted to/from CSV files with one line per poll: the time of the
+poll in ms followed by the bytes of the frame, see InputRecorder.h.
+
+  n64trace.py decode trace.bin trace.csv
+  n64trace.py encode trace.csv trace.bin [--period MS]
+  n64trace.py stats trace.bin
+  n64trace.py capture /dev/ttyACM0 trace.bin    (needs pyserial)
+"""
+
+import argparse
+import csv
+import sys
+
+MAGIC = b"NT"
+VERSION = 1
+MAX_FRAME_SIZE = 8
+MAX_RUN = 255
+
+
+class TraceError (Exception):
+	pass
+
+
+def encode (frames, frame_size, period_ms):
+	out = bytearray (MAGIC + bytes ([VERSION, frame_size, period_ms]))
+	last = [0] * frame_size
+	run = 0
+
+	def close_run ():
+		nonlocal run
+		if run > 0:
+			out.extend ((0x00, run))
+			run = 0
+
+	for frame in frames:
+		if len (frame) != frame_size:
+			raise TraceError ("Frame has %d bytes, expected %d" % (len (frame), frame_size))
+
+		mask = 0
+		for i in range (frame_size):
+			if frame[i] != last[i]:
+				mask |= 1 << i
+
+		if mask == 0:
+			run += 1
+			if run == MAX_RUN:
+				close_run ()
+		else:
+			close_run ()
+			out.append (mask)
+			for i in range (frame_size):
+				if mask & (1 << i):
+					out.append ((frame[i] - last[i]) & 0xFF)
+					last[i] = frame[i]
+
+	close_run ()
+	out.extend ((0x00, 0x00))
+	return bytes (out)
+
+
+def decode (data):
+	"""Returns frame size, poll period, list of frames and whether the end of
+	the trace was reached"""
+	if len (data) < 5 or data[0:2] != MAGIC:
+		raise TraceError ("Not a trace")
+	if data[2] != VERSION:
+		raise TraceError ("Unsupported trace version %d" % data[2])
+	frame_size, period_ms = data[3], data[4]
+	if not 0 < frame_size <= MAX_FRAME_SIZE:
+		raise TraceError ("Bad frame size %d" % frame_size)
+
+	frames = []
+	last = [0] * frame_size
+	pos = 5
+	ended = False
+	try:
+		while not ended:
+			mask = data[pos]
+			pos += 1
+			if mask == 0x00:
+				n = data[pos]
+				pos += 1
+				if n == 0:
+					ended = True
+					break
+				frames.extend ([list (last)] * n)
+			else:
+				for i in range (frame_size):
+					if mask & (1 << i):
+						last[i] = (last[i] + data[pos]) & 0xFF
+						pos += 1
+				frames.append (list (last))
+	except IndexError:
+		# Recording was interrupted, keep what we have
+		pass
+
+	return frame_size, period_ms, frames, ended
+
+
+def load (path):
+	with open (path, "rb") as f:
+		data = f.read ()
+
+	frame_size, period_ms, frames, ended = decode (data)
+	if not ended:
+		print ("Warning: trace is truncated", file = sys.stderr)
+
+	return data, frame_size, period_ms, frames
+
+
+def cmd_decode (args):
+	_, frame_size, period_ms, frames = load (args.trace)
+
+	with open (args.csv, "w", newline = "") as f:
+		w = csv.writer (f, lineterminator = "\n")
+		w.writerow (["ms"] + ["b%d" % i for i in range (frame_size)])
+		for n, frame in enumerate (frames):
+			w.writerow ([n * period_ms] + frame)
+
+
+def cmd_encode (args):
+	with open (args.csv, newline = "") as f:
+		rows = list (csv.reader (f))
+
+	# Skip header, drop time column
+	frames = [[int (v) & 0xFF for v in row[1:]] for row in rows[1:] if row]
+	if not frames:
+		raise TraceError ("No frames")
+
+	period = args.period
+	if period is None:
+		period = int (rows[2][0]) - int (rows[1][0]) if len (rows) > 2 else 0
+
+	with open (args.trace, "wb") as f:
+		f.write (encode (frames, len (frames[0]), period))
+
+
+def cmd_stats (args):
+	data, frame_size, period_ms, frames = load (args.trace)
+
+	raw = len (frames) * frame_size
+	print ("Frame size:  %d bytes" % frame_size)
+	print ("Poll period: %d ms" % period_ms)
+	print ("Polls:       %d (%.1f s)" % (len (frames), len (frames) * period_ms / 1000.0))
+	print ("Raw size:    %d bytes" % raw)
+	print ("Trace size:  %d bytes" % len (data))
+	if len (data) > 0:
+		print ("Ratio:       %.1f:1" % (raw / float (len (data))))
+	if frames:
+		print ("Per poll:    %.2f bytes" % (len (data) / float (len (frames))))
+
+
+def cmd_capture (args):
+	import serial
+
+	with serial.Serial (args.port, args.baud) as port, open (args.trace, "wb") as f:
+		# Wait for the header, anything before it is not ours
+		data = bytearray ()
+		try:
+			while data[-5:-3] != MAGIC:
+				data.extend (port.read (1))
+			data = data[-5:]
+
+			ended = False
+			while not ended:
+				data.extend (port.read (max (1, port.in_waiting)))
+				if data[-1] == 0x00:
+					ended = decode (bytes (data))[3]
+		except KeyboardInterrupt:
+			print ("Warning: trace is truncated", file = sys.stderr)
+
+		f.write (data)
+
+
+def main ():
+	parser = argparse.ArgumentParser (description = __doc__, formatter_class = argparse.RawDescriptionHelpFormatter)
+	sub = parser.add_subparsers (dest = "cmd", required = True)
+
+	p = sub.add_parser ("decode", help = "Convert a trace to CSV")
+	p.add_argument ("trace")
+	p.add_argument ("csv")
+	p.set_defaults (func = cmd_decode)
+
+	p = sub.add_parser ("encode", help = "Convert CSV to a trace")
+	p.add_argument ("csv")
+	p.add_argument ("trace")
+	p.add_argument ("--period", type = int, help = "Poll period in ms (default: from CSV)")
+	p.set_defaults (func = cmd_encode)
+
+	p = sub.add_parser ("stats", help = "Show size and compression ratio of a trace")
+	p.add_argument ("trace")
+	p.set_defaults (func = cmd_stats)
+
+	p = sub.add_parser ("capture", help = "Save a trace sent over a serial port")
+	p.add_argument ("port")
+	p.add_argument ("trace")
+	p.add_argument ("--baud", type = int, default = 115200)
+	p.set_defaults (func = cmd_capture)
+
+	args = parser.parse_args ()
+	try:
+		args.func (args)
+	except TraceError as e:
+		sys.exit ("Error: %s" % e)
+
+
+if __name__ == "__main__":
+	main ()
@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#include "AutoPad.h"
+
+/* Where each bit of the two button bytes of a reply ends up, MSB first. 0 means
+ * the bit is not a button.
+ */
+static const uint16_t n64ButtonMap[2][8] = {
+	{
+		AutoPad::BTN_A, AutoPad::BTN_B, AutoPad::BTN_Z, AutoPad::BTN_START,
+		AutoPad::BTN_D_UP, AutoPad::BTN_D_DOWN, AutoPad::BTN_D_LEFT, AutoPad::BTN_D_RIGHT
+	}, {
+		0 /* L+R+Start */, 0, AutoPad::BTN_L, AutoPad::BTN_R,
+		AutoPad::BTN_C_UP, AutoPad::BTN_C_DOWN, AutoPad::BTN_C_LEFT, AutoPad::BTN_C_RIGHT
+	}
+};
+
+static const uint16_t gcButtonMap[2][8] = {
+	{
+		0, 0, 0 /* Origin */, AutoPad::BTN_START,
+		AutoPad::BTN_Y, AutoPad::BTN_X, AutoPad::BTN_B, AutoPad::BTN_A
+	}, {
+		0, AutoPad::BTN_L, AutoPad::BTN_R, AutoPad::BTN_Z,
+		AutoPad::BTN_D_UP, AutoPad::BTN_D_DOWN, AutoPad::BTN_D_RIGHT, AutoPad::BTN_D_LEFT
+	}
+};
+
+static uint16_t mapButtons (const byte *buf, const uint16_t map[2][8]) {
+	uint16_t ret = 0;
+
+	for (byte i = 0; i < 2; ++i) {
+		byte b = buf[i];
+		for (byte j = 0; j < 8; ++j) {
+			if (b & 0x80)
+				ret |= map[i][j];
+			b <<= 1;
+		}
+	}
+
+	return ret;
+}
+
+// Moves a stick axis so that the origin ends up at 0
+static int8_t center (uint8_t v, uint8_t origin) {
+	int16_t c = (int16_t) v - origin;
+	return c < -128 ? -128 : (c > 127 ? 127 : c);
+}
+
+// Moves a trigger so that the origin ends up at 0
+static uint8_t release (uint8_t v, uint8_t origin) {
+	return v > origin ? v - origin : 0;
+}
+
+template <boolean MOUSE>
+void AutoPad::decodeN64 (AutoPad& pad) {
+	pad.state.buttons = mapButtons (pad.buf, n64ButtonMap);
+
+	// The mouse reports movement instead of position, but in the same place
+	pad.state.x = (int8_t) pad.buf[2];
+	pad.state.y = (int8_t) pad.buf[3];
+
+	if (!MOUSE) {
+		pad.state.left_trigger = (pad.state.buttons & BTN_L) ? 255 : 0;
+		pad.state.right_trigger = (pad.state.buttons & BTN_R) ? 255 : 0;
+	}
+}
+
+void AutoPad::decodeGcPad (AutoPad& pad) {
+	const byte *buf = pad.buf;
+
+	// Poll is always done in analog mode 3, see drivers below
+	pad.state.buttons = mapButtons (buf, gcButtonMap);
+	pad.state.x = center (buf[2], pad.origin[0]);
+	pad.state.y = center (buf[3], pad.origin[1]);
+	pad.state.c_x = center (buf[4], pad.origin[2]);
+	pad.state.c_y = center (buf[5], pad.origin[3]);
+	pad.state.left_trigger = release (buf[6], pad.origin[4]);
+	pad.state.right_trigger = release (buf[7], pad.origin[5]);
+
+	// Can't send another command from here, read() will take care of it
+	pad.needOrigin = (buf[0] & 0x20) != 0;
+}
+
+void AutoPad::decodeGcKeyboard (AutoPad& pad) {
+	// First 4 bytes are a counter and status bits, last one is a checksum
+	for (byte i = 0; i < 3; ++i)
+		pad.state.keys[i] = pad.buf[i + 4];
+}
+
+/* These must follow the order from DeviceType: command length, command (up to
+ * COMMAND_SIZE bytes), reply length, fixed bits mask and value, decoder
+ */
+const AutoPad::Driver AutoPad::drivers[DEV_NUMBER] = {
+	// DEV_NONE - Never polled
+	{0, {0x00}, 0, 0x0000, 0x0000, NULL},
+
+	// DEV_N64_PAD - Bit 6 of the second byte is never set
+	{1, {0x01}, 4, 0x0040, 0x0000, decodeN64<false>},
+
+	// DEV_N64_MOUSE - Same as above
+	{1, {0x01}, 4, 0x0040, 0x0000, decodeN64<true>},
+
+	/* DEV_GC_PAD - Analog mode 3, rumble off. Bits 15 and 14 are always 0, bit 7
+	 * is always 1
+	 */
+	{3, {0x40, 0x03, 0x02}, 8, 0xC080, 0x0080, decodeGcPad},
+
+	// DEV_GC_WAVEBIRD - Same as above
+	{3, {0x40, 0x03, 0x02}, 8, 0xC080, 0x0080, decodeGcPad},
+
+	// DEV_GC_KEYBOARD - No fixed bits we can count on, only the stop bit is checked
+	{3, {0x54, 0x00, 0x00}, 8, 0x0000, 0x0000, decodeGcKeyboard}
+};
+
+boolean AutoPad::begin () {
+	static const byte CMD_IDENTIFY = 0x00;
+	static const byte CMD_RESET = 0xFF;
+
+	proto.begin ();
+
+	type = DEV_NONE;
+	memset (&state, 0x00, sizeof (state));
+	needOrigin = false;
+	last_poll = 0;
+
+	// Just in case we don't get a proper one
+	origin[0] = origin[1] = origin[2] = origin[3] = 128;
+	origin[4] = origin[5] = 0;
+
+	/* Everything answers to identify with 3 bytes, the first two tell us what
+	 * the device is:
+	 * - 0x0500: N64 controller
+	 * - 0x0200: N64 mouse
+	 * - 0x0900: GC controller
+	 * - 0x0820: GC keyboard
+	 * - 0xE9A0 and similar: WaveBird, bit 7 means wireless
+	 */
+	if (runCommand (&CMD_IDENTIFY, 1, 3)) {
+		DeviceType t = DEV_NONE;
+		if (buf[0] == 0x05) {
+			t = DEV_N64_PAD;
+		} else if (buf[0] == 0x02) {
+			t = DEV_N64_MOUSE;
+		} else if (buf[0] == 0x08 && buf[1] == 0x20) {
+			t = DEV_GC_KEYBOARD;
+		} else if (buf[0] & 0x80) {
+			t = DEV_GC_WAVEBIRD;
+		} else if (buf[0] & 0x08) {
+			t = DEV_GC_PAD;
+		}
+
+		switch (t) {
+			case DEV_N64_PAD:
+				// This also recenters the stick, as N64Pad does
+				if (runCommand (&CMD_RESET, 1, 3))
+					type = t;
+				break;
+			case DEV_GC_PAD:
+			case DEV_GC_WAVEBIRD:
+				// No sense in reading analog values before we have the origin
+				if (readOrigin ())
+					type = t;
+				break;
+			default:
+				type = t;
+				break;
+		}
+	}
+
+	return type != DEV_NONE;
+}
+
+boolean AutoPad::readOrigin () {
+	static const byte CMD_ORIGIN = 0x41;
+
+	boolean ret = false;
+
+	// Same layout as a poll in mode 3, after the two button bytes
+	if (runCommand (&CMD_ORIGIN, 1, 10)) {
+		for (byte i = 0; i < 6; ++i)
+			origin[i] = buf[i + 2];
+		ret = true;
+	}
+
+	return ret;
+}
+
+boolean AutoPad::read () {
+	boolean ret = false;
+
+	if (type != DEV_NONE) {
+		ret = true;
+
+		if (pollDue ()) {
+			const Driver& drv = drivers[type];
+			if ((ret = proto.runPoll (drv.cmd, drv.cmdsz, buf, drv.repsz, drv.fixedMask, drv.fixedBits, *this))) {
+				drv.decode (*this);
+
+				if (needOrigin) {
+					readOrigin ();
+					needOrigin = false;
+				}
+
+				last_poll = millis ();
+			}
+		}
+	}
+
+	return ret;
+}
+
+boolean AutoPad::runCommand (const byte *cmd, byte cmdsz, byte repsz) {
+	return proto.runCommand (cmd, cmdsz, buf, repsz);
+}
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#ifndef AUTOPAD_INCLUDED
+#define AUTOPAD_INCLUDED
+
+#include "protocol/N64PadProtocol.h"
+
+/* State of any supported device, normalized so that the same code can handle
+ * all of them
+ */
+struct AutoPadState {
+	// Use AutoPad::PadButton values to test this. 1 means pressed.
+	uint16_t buttons;
+
+	/* Main stick, centered at 0, positive RIGHT/UP. For the N64 mouse, this is
+	 * the movement since the previous read().
+	 */
+	int8_t x;
+	int8_t y;
+
+	// C-Stick, same as above. Always 0 on the N64 pad, see BTN_C_*.
+	int8_t c_x;
+	int8_t c_y;
+
+	/* Triggers, 0 when released. The N64 pad only has digital ones, which are
+	 * reported as either 0 or 255.
+	 */
+	uint8_t left_trigger;
+	uint8_t right_trigger;
+
+	// Keys pressed on the GC keyboard, 0 if none
+	uint8_t keys[3];
+};
+
+/* Driver for any device that can be connected to a N64 or GC port.
+ *
+ * begin() asks the device what it is and picks the matching decoder, which is
+ * then called through a table lookup on every read(), so there is no overhead
+ * compared to N64Pad/GCPad. See PollStats and PollSchedule for the members they
+ * add.
+ */
+class AutoPad: public PollStats, public PollSchedule {
+public:
+	static const byte MIN_POLL_INTERVAL_MS = 1000U / 60U;
+
+	enum DeviceType {
+		DEV_NONE = 0,
+		DEV_N64_PAD,
+		DEV_N64_MOUSE,
+		DEV_GC_PAD,
+		DEV_GC_WAVEBIRD,
+		DEV_GC_KEYBOARD,
+
+		DEV_NUMBER    // Leave at end
+	};
+
+	enum PadButton {
+		BTN_A       = 1 << 0,		// Left button on the N64 mouse
+		BTN_B       = 1 << 1,		// Right button on the N64 mouse
+		BTN_X       = 1 << 2,
+		BTN_Y       = 1 << 3,
+		BTN_Z       = 1 << 4,
+		BTN_START   = 1 << 5,
+		BTN_L       = 1 << 6,
+		BTN_R       = 1 << 7,
+		BTN_D_UP    = 1 << 8,
+		BTN_D_DOWN  = 1 << 9,
+		BTN_D_LEFT  = 1 << 10,
+		BTN_D_RIGHT = 1 << 11,
+		BTN_C_UP    = 1 << 12,
+		BTN_C_DOWN  = 1 << 13,
+		BTN_C_LEFT  = 1 << 14,
+		BTN_C_RIGHT = 1 << 15
+	};
+
+	// What is connected, as detected by begin()
+	DeviceType type;
+
+	// Current state, updated by read()
+	AutoPadState state;
+
+	AutoPad (): PollSchedule (MIN_POLL_INTERVAL_MS), type (DEV_NONE) {}
+
+	/* Detects what is connected and gets it ready. This can also be called
+	 * anytime to reset the device.
+	 */
+	boolean begin ();
+
+	/* Reads the current state of the device.
+	 *
+	 * Note that this functions disables interrupts and runs for 160-350+ us,
+	 * depending on the device!
+	 */
+	boolean read ();
+
+private:
+	N64PadProtocol proto;
+
+	// Maximum size of a single command in bytes
+	static const byte COMMAND_SIZE = 3;
+
+	struct Driver {
+		// Command to send and expected reply length
+		byte cmdsz;
+		byte cmd[COMMAND_SIZE];
+		byte repsz;
+
+		/* Bits of the first two reply bytes that are fixed by the protocol
+		 * and what they must be, see N64PadProtocol::runPoll()
+		 */
+		uint16_t fixedMask;
+		uint16_t fixedBits;
+
+		// Turns the reply into state
+		void (*decode) (AutoPad& pad);
+	};
+
+	// Indexed by DeviceType
+	static const Driver drivers[DEV_NUMBER];
+
+	// 10 is enough for all our uses
+	byte buf[10];
+
+	/* Neutral position of GC analog controls: x, y, c_x, c_y, left_trigger,
+	 * right_trigger
+	 */
+	byte origin[6];
+
+	// Set by the GC decoder when the controller asks us to re-read the origin
+	boolean needOrigin;
+
+	boolean runCommand (const byte *cmd, byte cmdsz, byte repsz);
+
+	boolean readOrigin ();
+
+	template <boolean MOUSE>
+	static void decodeN64 (AutoPad& pad);
+
+	static void decodeGcPad (AutoPad& pad);
+
+	static void decodeGcKeyboard (AutoPad& pad);
+};
+
+#endif
@@ -20,47 +20,162 @@
 #include "GCPad.h"
 
 /* These must follow the order from ProtoCommand, first byte is expected length
- * of reply
+ * of reply, second one is length of the command
  */
-const byte GCPad::protoCommands[CMD_NUMBER][COMMAND_SIZE + 1] = {
-	// CMD_POLL - Buffer size required: 8 bytes
-	{8, 0x40, 0x03, 0x02},
+const byte GCPad::protoCommands[CMD_NUMBER][COMMAND_SIZE + 2] = {
+	// CMD_IDENTIFY - Buffer size required: 3 bytes
+	{3, 1, 0x00},
+
+	/* CMD_POLL - 8. The second byte is the analog mode, which is replaced at
+	 * runtime
+	 */
+	{8, 3, 0x40, 0x03, 0x02},
+
+	// CMD_ORIGIN - 10
+	{10, 1, 0x41},
+
+	// CMD_RECALIBRATE - 10
+	{10, 3, 0x42, 0x00, 0x00},
 
 	// CMD_RUMBLE_ON - Do we even have a reply?
-	{1, 0x40, 0x00, 0x01},
+	{1, 3, 0x40, 0x00, 0x01},
 
 	// CMD_RUMBLE_OFF - Ditto
-	{1, 0x40, 0x00, 0x00}
+	{1, 3, 0x40, 0x00, 0x00}
 };
 
+// Moves a stick axis so that the origin ends up at 128
+static uint8_t center (uint8_t v, uint8_t origin) {
+	int16_t c = (int16_t) v - origin + 128;
+	return c < 0 ? 0 : (c > 255 ? 255 : c);
+}
+
+// Moves a trigger/analog button so that the origin ends up at 0
+static uint8_t release (uint8_t v, uint8_t origin) {
+	return v > origin ? v - origin : 0;
+}
+
 boolean GCPad::begin () {
+	proto.begin ();
+
 	buttons = 0;
-	x = 0;
-	y = 0;
-	c_x = 0;
-	c_y = 0;
+	x = 128;
+	y = 128;
+	c_x = 128;
+	c_y = 128;
 	left_trigger = 0;
 	right_trigger = 0;
+	analog_a = 0;
+	analog_b = 0;
 	
 	last_poll = 0;
 
-	// It seems we need nothing special
-	return true;
+	// Just in case we don't get a proper one
+	origin[0] = origin[1] = origin[2] = origin[3] = 128;
+	origin[4] = origin[5] = origin[6] = origin[7] = 0;
+
+	/* Any controller answers to identify, then we need the origin before we
+	 * can make sense of any analog value
+	 */
+	boolean ret = false;
+	if (runCommand (CMD_IDENTIFY) && runCommand (CMD_ORIGIN)) {
+		setOrigin ();
+		ret = true;
+	}
+
+	return ret;
+}
+
+void GCPad::setAnalogMode (AnalogMode mode) {
+	analogMode = mode;
+}
+
+boolean GCPad::recalibrate () {
+	boolean ret = false;
+
+	if (runCommand (CMD_RECALIBRATE)) {
+		setOrigin ();
+		ret = true;
+	}
+
+	return ret;
+}
+
+void GCPad::setOrigin () {
+	// Origin reply has the same layout as a poll in mode 3, plus analog A/B
+	for (byte i = 0; i < 8; ++i)
+		origin[i] = buf[i + 2];
 }
 
 boolean GCPad::read () {
 	boolean ret = true;
 	
-	if (last_poll == 0 || millis () - last_poll >= 10) {
-		if ((ret = (runCommand (CMD_POLL) != NULL))) {
-			// The mask makes sure unused bits are 0, some seem to be always 1
+	if (pollDue ()) {
+		// Bits 15 and 14 are always 0, bit 7 is always 1
+		byte cmdbuf[COMMAND_SIZE];
+		const byte cmdsz = makeCommand (CMD_POLL, cmdbuf);
+		if ((ret = proto.runPoll (cmdbuf, cmdsz, buf, protoCommands[CMD_POLL][0], 0xC080, 0x0080, *this))) {
+			// Clear the constant bits checked above and the origin flag
 			buttons = ((((uint16_t) buf[0]) << 8) | buf[1]) & ~(0xE080);
-			x = buf[2];
-			y = buf[3];
-			c_x = buf[4];
-			c_y = buf[5];
-			left_trigger = buf[6];
-			right_trigger = buf[7];
+
+			// Values only reported in the upper 4 bits come in pairs
+			uint8_t cx, cy, l, r, a, b;
+			switch (analogMode) {
+				case MODE_0:
+					cx = buf[4];
+					cy = buf[5];
+					l = buf[6] & 0xF0;
+					r = buf[6] << 4;
+					a = buf[7] & 0xF0;
+					b = buf[7] << 4;
+					break;
+				case MODE_1:
+					cx = buf[4] & 0xF0;
+					cy = buf[4] << 4;
+					l = buf[5];
+					r = buf[6];
+					a = buf[7] & 0xF0;
+					b = buf[7] << 4;
+					break;
+				case MODE_2:
+					cx = buf[4] & 0xF0;
+					cy = buf[4] << 4;
+					l = buf[5] & 0xF0;
+					r = buf[5] << 4;
+					a = buf[6];
+					b = buf[7];
+					break;
+				case MODE_4:
+					cx = buf[4];
+					cy = buf[5];
+					l = 0;
+					r = 0;
+					a = buf[6];
+					b = buf[7];
+					break;
+				case MODE_3:
+				default:
+					cx = buf[4];
+					cy = buf[5];
+					l = buf[6];
+					r = buf[7];
+					a = 0;
+					b = 0;
+					break;
+			}
+
+			x = center (buf[2], origin[0]);
+			y = center (buf[3], origin[1]);
+			c_x = center (cx, origin[2]);
+			c_y = center (cy, origin[3]);
+			left_trigger = release (l, origin[4]);
+			right_trigger = release (r, origin[5]);
+			analog_a = release (a, origin[6]);
+			analog_b = release (b, origin[7]);
+
+			// The controller wants us to re-read its origin
+			if ((buf[0] & 0x20) && runCommand (CMD_ORIGIN))
+				setOrigin ();
 
 			last_poll = millis ();
 		}
@@ -69,9 +184,21 @@ boolean GCPad::read () {
 	return ret;
 }
 
+byte GCPad::makeCommand (const ProtoCommand cmd, byte *cmdbuf) {
+	const byte cmdsz = protoCommands[cmd][1];
+	memcpy (cmdbuf, protoCommands[cmd] + 2, cmdsz);
+	if (cmd == CMD_POLL)
+		cmdbuf[1] = analogMode;
+
+	return cmdsz;
+}
+
 byte *GCPad::runCommand (const ProtoCommand cmd) {
 	byte *ret = NULL;
-	if (proto.runCommand (protoCommands[cmd] + 1, COMMAND_SIZE, buf, protoCommands[cmd][0])) {
+
+	byte cmdbuf[COMMAND_SIZE];
+	const byte cmdsz = makeCommand (cmd, cmdbuf);
+	if (proto.runCommand (cmdbuf, cmdsz, buf, protoCommands[cmd][0])) {
 		ret = buf;
 	}
 
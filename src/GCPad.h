@@ -23,12 +23,16 @@
 
 #include "protocol/N64PadProtocol.h"
 
-class GCPad {
+// See PollStats and PollSchedule for the members they add
+class GCPad: public PollStats, public PollSchedule {
 public:
+	static const byte MIN_POLL_INTERVAL_MS = 10;
+
 	enum PadButton {
 		/* Always 0 = 1 << 15, */
 		/* Always 0 = 1 << 14, */
-		/* Unknown  = 1 << 13, */
+		/* Origin   = 1 << 13, Set when the controller wants us to re-read
+		 *                     its origin, handled internally */
 		BTN_START   = 1 << 12,
 		BTN_Y       = 1 << 11,
 		BTN_X       = 1 << 10,
@@ -47,11 +51,30 @@ public:
 	// Button status register. Use PadButton values to test this. 1 means pressed.
 	uint16_t buttons;
 
+	/* Analog modes, see setAnalogMode(). They differ in which analog values
+	 * are reported in full 8-bit resolution, which only in the upper 4 bits
+	 * and which not at all (i.e.: always 0).
+	 */
+	enum AnalogMode {
+		MODE_0 = 0,		// Sticks full, triggers and A/B 4-bit
+		MODE_1 = 1,		// Main stick and triggers full, C-Stick and A/B 4-bit
+		MODE_2 = 2,		// Main stick and A/B full, C-Stick and triggers 4-bit
+		MODE_3 = 3,		// Sticks and triggers full, no A/B (Default)
+		MODE_4 = 4		// Sticks and A/B full, no triggers
+	};
+
+	/* All analog values below are adjusted according to the origin (i.e.:
+	 * the neutral position) reported by the controller when it is connected,
+	 * so that sticks are at 128 and triggers at 0 when released. The
+	 * controller might ask to re-read the origin later (i.e.: after X + Y +
+	 * Start have been held for a few seconds), which is taken care of.
+	 */
+
 	/* X-Axis coordinate (Growing RIGHT)
 	 *
-	 * Range for analog position is -128 to 127, however, true GameCube
-	 * controller is mechanically limited, so the actual range is about
-	 * 20 to 225.
+	 * Range for analog position is 0 to 255, with 128 at the center. However,
+	 * true GameCube controller is mechanically limited, so the actual range
+	 * is about 20 to 225.
 	 */
 	uint8_t x;
 
@@ -63,9 +86,7 @@ public:
 
 	/* C-Stick X-Axis coordinate (Growing RIGHT)
 	 *
-	 * Range for analog position is -128 to 127, however, true GameCube
-	 * controller is mechanically limited, so the actual range is about
-	 * 20 to 225.
+	 * See the comment about x above
 	 */
 	uint8_t c_x;
 
@@ -78,8 +99,7 @@ public:
 	/* Left trigger
 	 * 
 	 * Range is 0-255, but full range seems to be hard to reach. The L
-	 * button seems to trigger at ~200. Note that this might not be 0 when
-	 * fully unpressed!
+	 * button seems to trigger at ~200.
 	 */
 	uint8_t left_trigger;
 
@@ -89,9 +109,36 @@ public:
 	 */
 	uint8_t right_trigger;
 
-	// This can also be called anytime to reset the controller
+	/* Analog A button
+	 *
+	 * Only reported in some analog modes, official controllers always
+	 * report 0 anyway.
+	 */
+	uint8_t analog_a;
+
+	/* Analog B button
+	 *
+	 * See the comment about analog_a above
+	 */
+	uint8_t analog_b;
+
+	GCPad (): PollSchedule (MIN_POLL_INTERVAL_MS), analogMode (MODE_3) {}
+
+	/* This can also be called anytime to reset the controller. It makes sure
+	 * a controller is there and reads its origin.
+	 */
 	boolean begin ();
 
+	/* Selects what analog values are reported by read() and with how many
+	 * bits, see AnalogMode. This takes effect on the next read().
+	 */
+	void setAnalogMode (AnalogMode mode);
+
+	/* Makes the controller take its current position as the new origin, as
+	 * holding X + Y + Start does.
+	 */
+	boolean recalibrate ();
+
 	/* Reads the current state of the joystick.
 	 *
 	 * Note that this functions disables interrupts and runs for 350+ us!
@@ -101,24 +148,38 @@ public:
 private:
 	N64PadProtocol proto;
 	
-	// Size of a single command in bytes, seems fixed
+	// Maximum size of a single command in bytes
 	static const int COMMAND_SIZE = 3;
 	
 	enum ProtoCommand {
-		CMD_POLL = 0,
-		CMD_RUMBLE_ON = 1,
-		CMD_RUMBLE_OFF = 2,
+		CMD_IDENTIFY = 0,
+		CMD_POLL,
+		CMD_ORIGIN,
+		CMD_RECALIBRATE,
+		CMD_RUMBLE_ON,
+		CMD_RUMBLE_OFF,
 		CMD_NUMBER    // Leave at end
 	};
 
-	// First byte is expected reply length
-	static const byte protoCommands[CMD_NUMBER][COMMAND_SIZE + 1];
+	// First byte is expected reply length, second is command length
+	static const byte protoCommands[CMD_NUMBER][COMMAND_SIZE + 2];
+
+	// 10 is enough for all our uses
+	byte buf[10];
 
-	// 8 should enough for all our uses
-	byte buf[8];
+	AnalogMode analogMode;
 
-	// millis() last time controller was polled
-	unsigned long last_poll;
+	/* Neutral position of the analog controls, as returned by the origin
+	 * command: x, y, c_x, c_y, left_trigger, right_trigger, analog_a,
+	 * analog_b
+	 */
+	byte origin[8];
+
+	// Puts cmd into cmdbuf, with the current analog mode, returns its length
+	byte makeCommand (const ProtoCommand cmd, byte *cmdbuf);
 
 	byte *runCommand (const ProtoCommand cmd);
+
+	// Fills in origin[] from a reply to the origin/recalibrate command
+	void setOrigin ();
 };
@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#include <avr/eeprom.h>
+#include "InputRecorder.h"
+#include "N64Pad.h"
+#include "GCPad.h"
+
+static const byte TRACE_MAGIC_0 = 'N';
+static const byte TRACE_MAGIC_1 = 'T';
+static const byte TRACE_VERSION = 1;
+
+// Longest run of unchanged frames that fits a single record
+static const byte MAX_RUN = 255;
+
+void packFrame (const N64Pad& pad, byte *frame) {
+	frame[0] = pad.buttons >> 8;
+	frame[1] = pad.buttons & 0xFF;
+	frame[2] = pad.x;
+	frame[3] = pad.y;
+}
+
+void unpackFrame (const byte *frame, N64Pad& pad) {
+	pad.buttons = (((uint16_t) frame[0]) << 8) | frame[1];
+	pad.x = (int8_t) frame[2];
+	pad.y = (int8_t) frame[3];
+}
+
+void packFrame (const GCPad& pad, byte *frame) {
+	frame[0] = pad.buttons >> 8;
+	frame[1] = pad.buttons & 0xFF;
+	frame[2] = pad.x;
+	frame[3] = pad.y;
+	frame[4] = pad.c_x;
+	frame[5] = pad.c_y;
+	frame[6] = pad.left_trigger;
+	frame[7] = pad.right_trigger;
+}
+
+void unpackFrame (const byte *frame, GCPad& pad) {
+	pad.buttons = (((uint16_t) frame[0]) << 8) | frame[1];
+	pad.x = frame[2];
+	pad.y = frame[3];
+	pad.c_x = frame[4];
+	pad.c_y = frame[5];
+	pad.left_trigger = frame[6];
+	pad.right_trigger = frame[7];
+}
+
+void InputRecorder::begin (Print& _out, byte _frameSize, byte periodMs) {
+	out = &_out;
+	frameSize = _frameSize > MAX_FRAME_SIZE ? MAX_FRAME_SIZE : _frameSize;
+	head = 0;
+	pending = 0;
+	run = 0;
+	polls = 0;
+	traceBytes = 0;
+	memset (last, 0x00, sizeof (last));
+
+	put (TRACE_MAGIC_0);
+	put (TRACE_MAGIC_1);
+	put (TRACE_VERSION);
+	put (frameSize);
+	put (periodMs);
+}
+
+void InputRecorder::record (const byte *frame) {
+	byte mask = 0;
+	for (byte i = 0; i < frameSize; ++i) {
+		if (frame[i] != last[i])
+			mask |= 1 << i;
+	}
+
+	if (mask == 0) {
+		// Most polls end up here, so this must be quick
+		if (++run == MAX_RUN)
+			closeRun ();
+	} else {
+		closeRun ();
+		put (mask);
+		for (byte i = 0; i < frameSize; ++i) {
+			if (mask & (1 << i)) {
+				put (frame[i] - last[i]);
+				last[i] = frame[i];
+			}
+		}
+	}
+
+	++polls;
+}
+
+void InputRecorder::closeRun () {
+	if (run > 0) {
+		put (0x00);
+		put (run);
+		run = 0;
+	}
+}
+
+void InputRecorder::put (byte b) {
+	if (pending == ringSize)
+		flush ();
+
+	ring[head] = b;
+	if (++head == ringSize)
+		head = 0;
+	++pending;
+	++traceBytes;
+}
+
+void InputRecorder::flush () {
+	// Pending data might wrap around the end of the buffer
+	while (pending > 0) {
+		unsigned int tail = head >= pending ? head - pending : head + ringSize - pending;
+		unsigned int len = ringSize - tail;
+		if (len > pending)
+			len = pending;
+
+		out -> write (ring + tail, len);
+		pending -= len;
+	}
+}
+
+void InputRecorder::end () {
+	closeRun ();
+	put (0x00);
+	put (0x00);
+	flush ();
+}
+
+boolean InputReplay::begin (Stream& _in) {
+	in = &_in;
+	run = 0;
+	done = false;
+	memset (last, 0x00, sizeof (last));
+
+	byte header[5];
+	boolean ret = in -> readBytes (header, sizeof (header)) == sizeof (header) &&
+				  header[0] == TRACE_MAGIC_0 && header[1] == TRACE_MAGIC_1 &&
+				  header[2] == TRACE_VERSION &&
+				  header[3] > 0 && header[3] <= InputRecorder::MAX_FRAME_SIZE;
+	if (ret) {
+		frameSize = header[3];
+		periodMs = header[4];
+	} else {
+		done = true;
+	}
+
+	return ret;
+}
+
+boolean InputReplay::next (byte *frame) {
+	boolean ret = false;
+
+	if (run > 0) {
+		--run;
+		ret = true;
+	} else if (!done && in -> available () > 0) {
+		// Rest of the record will follow shortly, readBytes() waits for it
+		byte mask = in -> read ();
+		if (mask == 0x00) {
+			byte n = 0;
+			in -> readBytes (&n, 1);
+			if (n == 0) {
+				done = true;
+			} else {
+				run = n - 1;
+				ret = true;
+			}
+		} else {
+			for (byte i = 0; i < frameSize; ++i) {
+				if (mask & (1 << i)) {
+					byte delta = 0;
+					in -> readBytes (&delta, 1);
+					last[i] += delta;
+				}
+			}
+			ret = true;
+		}
+	}
+
+	if (ret)
+		memcpy (frame, last, frameSize);
+
+	return ret;
+}
+
+size_t EepromStream::write (uint8_t b) {
+	size_t ret = 0;
+
+	if (pos < end) {
+		eeprom_update_byte ((uint8_t *) pos++, b);
+		ret = 1;
+	}
+
+	return ret;
+}
+
+int EepromStream::available () {
+	return end - pos;
+}
+
+int EepromStream::read () {
+	int ret = -1;
+
+	if (pos < end)
+		ret = eeprom_read_byte ((const uint8_t *) pos++);
+
+	return ret;
+}
+
+int EepromStream::peek () {
+	int ret = -1;
+
+	if (pos < end)
+		ret = eeprom_read_byte ((const uint8_t *) pos);
+
+	return ret;
+}
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * Trace format, as written by InputRecorder and read by InputReplay and by
+ * extras/n64trace.py:
+ *
+ * Header (5 bytes): 'N', 'T', version (1), frame size, poll period in ms
+ *
+ * Then, for every poll, in order:
+ * - mask, followed by one byte for every bit set in it: the fields of the frame
+ *   that changed since the previous poll, and by how much (new - old, mod 256).
+ *   Fields start out as 0.
+ * - 0x00, n (1-255): the frame did not change for n polls.
+ * - 0x00, 0x00: end of trace.
+ */
+
+#ifndef INPUTRECORDER_INCLUDED
+#define INPUTRECORDER_INCLUDED
+
+#include <Arduino.h>
+
+class N64Pad;
+class GCPad;
+
+/* A frame is the state of a controller after a poll, as a few bytes which can
+ * be compared and coded independently. These convert to and from the state of
+ * the pad classes:
+ * - N64Pad: buttons (MSB, LSB), x, y
+ * - GCPad: buttons (MSB, LSB), x, y, c_x, c_y, left_trigger, right_trigger.
+ *   analog_a/b are not recorded, so only analog mode 3 can be replayed in full.
+ */
+const byte N64_FRAME_SIZE = 4;
+const byte GC_FRAME_SIZE = 8;
+
+void packFrame (const N64Pad& pad, byte *frame);
+void unpackFrame (const byte *frame, N64Pad& pad);
+void packFrame (const GCPad& pad, byte *frame);
+void unpackFrame (const byte *frame, GCPad& pad);
+
+/* Records a frame per poll into a RAM ring buffer, which is written out to a
+ * Print (Serial, EepromStream, ...) by flush(). Call flush() whenever there is
+ * time for it, i.e.: right after a poll. If the buffer fills up, record() will
+ * flush it itself, which takes time.
+ *
+ *   recorder.begin (Serial, GC_FRAME_SIZE, 10);
+ *   ...
+ *   pad.read ();
+ *   packFrame (pad, frame);
+ *   recorder.record (frame);
+ *   recorder.flush ();
+ */
+class InputRecorder {
+public:
+	static const byte MAX_FRAME_SIZE = 8;
+
+	// Polls recorded so far
+	unsigned long polls;
+
+	// Bytes of trace produced so far, including the header
+	unsigned long traceBytes;
+
+	InputRecorder (byte *buf, unsigned int size): ring (buf), ringSize (size) {}
+
+	/* Starts a new trace, of frames of frameSize (1 to MAX_FRAME_SIZE) bytes
+	 * recorded every periodMs. The latter is only used for replaying.
+	 */
+	void begin (Print& out, byte frameSize, byte periodMs);
+
+	// Records the frame read by a poll, call once per poll
+	void record (const byte *frame);
+
+	// Writes everything recorded so far to the output
+	void flush ();
+
+	// Closes the trace and flushes it
+	void end ();
+
+private:
+	Print *out;
+
+	byte *ring;
+	unsigned int ringSize;
+
+	// Next byte to be written and number of bytes waiting to be flushed
+	unsigned int head;
+	unsigned int pending;
+
+	byte frameSize;
+
+	// Last recorded frame
+	byte last[MAX_FRAME_SIZE];
+
+	// Polls without changes not written yet
+	byte run;
+
+	void put (byte b);
+
+	void closeRun ();
+};
+
+/* Plays back a trace written by InputRecorder, a frame per call to next(),
+ * which should then be called every periodMs, as it was recorded.
+ */
+class InputReplay {
+public:
+	// From the trace header, valid after begin() has succeeded
+	byte frameSize;
+	byte periodMs;
+
+	// Reads the trace header, returns false if it is not valid
+	boolean begin (Stream& in);
+
+	/* Gets the frame for the next poll. Returns false if none is available
+	 * (yet) or if the trace is over.
+	 */
+	boolean next (byte *frame);
+
+	// Returns true when the end of the trace has been reached
+	boolean finished () const {
+		return done;
+	}
+
+private:
+	Stream *in;
+
+	byte last[InputRecorder::MAX_FRAME_SIZE];
+
+	// Polls left in the current run of unchanged frames
+	byte run;
+
+	boolean done;
+};
+
+/* Makes (part of) the EEPROM look like a Stream, to store a trace. Writing
+ * starts at the beginning of the range after rewind(), and so does reading.
+ */
+class EepromStream: public Stream {
+public:
+	EepromStream (unsigned int start = 0, unsigned int end = E2END + 1):
+		start (start), end (end), pos (start) {}
+
+	void rewind () {
+		pos = start;
+	}
+
+	virtual size_t write (uint8_t b);
+	virtual int available ();
+	virtual int read ();
+	virtual int peek ();
+	virtual void flush () {}
+
+	using Print::write;
+
+private:
+	unsigned int start;
+	unsigned int end;
+	unsigned int pos;
+};
+
+#endif
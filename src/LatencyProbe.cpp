@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#include "LatencyProbe.h"
+
+void LatencyProbe::begin (uint16_t _mask, unsigned long _maxGapUs) {
+	mask = _mask;
+	maxGapUs = _maxGapUs;
+	pressed = false;
+	pending = false;
+
+	trials = 0;
+	minUs = 0xFFFFFFFFUL;
+	maxUs = 0;
+	avg = 0;
+	m2 = 0;
+	memset (histogram, 0x00, sizeof (histogram));
+
+	schedule ();
+}
+
+void LatencyProbe::schedule () {
+	flipTime = micros () + random (maxGapUs);
+}
+
+void LatencyProbe::sample () {
+	// Signed difference, so that this keeps working when micros() wraps
+	if (!pending && (long) (micros () - flipTime) >= 0) {
+		pressed = !pressed;
+		pending = true;
+	}
+}
+
+void LatencyProbe::apply (uint16_t& buttons) {
+	if (pressed)
+		buttons |= mask;
+	else
+		buttons &= ~mask;
+}
+
+boolean LatencyProbe::output () {
+	boolean ret = pending;
+
+	if (pending) {
+		unsigned long lat = micros () - flipTime;
+
+		++trials;
+		if (lat < minUs)
+			minUs = lat;
+		if (lat > maxUs)
+			maxUs = lat;
+
+		float delta = lat - avg;
+		avg += delta / trials;
+		m2 += delta * (lat - avg);
+
+		unsigned long bucket = lat / BUCKET_US;
+		if (bucket >= BUCKETS)
+			bucket = BUCKETS - 1;
+		if (histogram[bucket] < 0xFFFF)
+			++histogram[bucket];
+
+		pending = false;
+		schedule ();
+	}
+
+	return ret;
+}
+
+float LatencyProbe::jitter () const {
+	return trials > 1 ? sqrt (m2 / (trials - 1)) : 0;
+}
+
+unsigned long LatencyProbe::percentile (byte pct) const {
+	unsigned long ret = 0;
+
+	// Smallest bucket reaching the wanted number of trials
+	unsigned long wanted = (trials * pct + 99) / 100;
+	unsigned long count = 0;
+	for (unsigned int i = 0; i < BUCKETS && count < wanted; ++i) {
+		count += histogram[i];
+		ret = (i + 1UL) * BUCKET_US;
+	}
+
+	return ret;
+}
+
+void LatencyProbe::report (Print& out) const {
+	out.print (F("Trials: "));
+	out.print (trials);
+	out.print (F(" - Latency (us): min "));
+	out.print (trials > 0 ? minUs : 0);
+	out.print (F(", mean "));
+	out.print (mean (), 0);
+	out.print (F(", p99 <= "));
+	out.print (percentile (99));
+	out.print (F(", max "));
+	out.print (maxUs);
+	out.print (F(" - Jitter (us): "));
+	out.println (jitter (), 0);
+}
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#ifndef LATENCYPROBE_INCLUDED
+#define LATENCYPROBE_INCLUDED
+
+#include <Arduino.h>
+
+/* Measures the input latency of an adapter sketch, i.e.: how long it takes for
+ * a button to go from being pressed on the controller to showing up on the
+ * output.
+ *
+ * The probe acts as a virtual button on the controller, which flips at a
+ * random moment, with no relation to when polls happen. Every poll made after
+ * that moment sees the button flipped, and the trial ends as soon as the new
+ * state has been output. Then the next trial is scheduled. Use it like this:
+ *
+ *   if (pad.timeToNextPoll () == 0)
+ *       probe.sample ();				// The controller is read now
+ *   pad.read ();
+ *   probe.apply (pad.buttons);			// Inject the virtual button
+ *   // ... Output pad state ...
+ *   probe.output ();					// Output is done
+ *
+ * This covers everything from the poll schedule to the output, but not what
+ * happens after the output has been updated. For USB, the host takes the
+ * report within one polling interval (1 ms for the Arduino HID endpoint, so
+ * add 0.5 ms on average). A console reads its port once per frame.
+ *
+ * Whatever the real controller reports for the button used by the probe is
+ * overridden, so don't press it while measuring.
+ */
+class LatencyProbe {
+public:
+	// Width of the histogram buckets used for percentiles, in us
+	static const unsigned int BUCKET_US = 100;
+
+	// Number of buckets, the last one takes all latencies above it
+	static const unsigned int BUCKETS = 256;
+
+	// Completed trials
+	unsigned long trials;
+
+	// Lowest and highest latency, in us
+	unsigned long minUs;
+	unsigned long maxUs;
+
+	/* Starts measuring. The virtual button is mask in the pad button
+	 * register. Trials are spaced by a random time up to maxGapUs, which
+	 * should be longer than the poll interval for the phase to be random.
+	 */
+	void begin (uint16_t mask, unsigned long maxGapUs);
+
+	// Call right before the controller is polled
+	void sample ();
+
+	// Call after every read(), puts the virtual button into buttons
+	void apply (uint16_t& buttons);
+
+	/* Call once the new state has been output. Returns true if this completed
+	 * a trial.
+	 */
+	boolean output ();
+
+	// Mean latency, in us
+	float mean () const {
+		return avg;
+	}
+
+	// Standard deviation of the latency, in us
+	float jitter () const;
+
+	/* Latency that is not exceeded in the given percentage of trials, in us,
+	 * rounded up to a bucket boundary
+	 */
+	unsigned long percentile (byte pct) const;
+
+	// Prints all of the above on a single line
+	void report (Print& out) const;
+
+private:
+	uint16_t mask;
+	unsigned long maxGapUs;
+
+	// micros() when the virtual button flips
+	unsigned long flipTime;
+
+	// State of the virtual button as seen by the last poll
+	boolean pressed;
+
+	// The last poll saw a flip that was not output yet
+	boolean pending;
+
+	// Running mean and sum of squared deviations (Welford)
+	float avg;
+	float m2;
+
+	uint16_t histogram[BUCKETS];
+
+	void schedule ();
+};
+
+#endif
@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#include <Arduino.h>
+#include "output/mdpinconfig.h"
+
+#ifdef MEGADRIVE_OUTPUT_SUPPORTED
+
+// ISRs are only wanted in the sketch, see MegaDriveOutput.h
+#define MEGADRIVEOUTPUT_NO_ISR
+#include "MegaDriveOutput.h"
+
+// Timer 2 runs with a prescaler of 1024, i.e.: 64 us per tick at 16 MHz
+#define US_TO_T2TICKS(us) ((us) * (F_CPU / 1000000UL) / 1024UL)
+
+/* Port bytes for every step of the TH cycle, indexed by mdStep. Steps are
+ * counted from the last timeout, even ones have SELECT high:
+ * - 0, 2, 4: Up, Down, Left, Right, B, C
+ * - 1, 3: Up, Down, 0, 0, A, Start
+ * - 5: 0, 0, 0, 0, A, Start (This tells the console we have 6 buttons)
+ * - 6: Z, Y, X, Mode, B, C
+ * - 7: 1, 1, 1, 1, A, Start
+ *
+ * On a 3-button pad 5-7 are just the same as 1-3.
+ */
+volatile byte mdTable[8];
+
+// Current step
+volatile byte mdStep;
+
+// Byte to output on next SELECT edge, always mdTable[(mdStep + 1) & 0x07]
+volatile byte mdNext;
+
+// Set when a controller poll slot is open
+volatile boolean mdSlot;
+
+void MegaDriveOutput::begin (boolean _sixButtons) {
+	sixButtons = _sixButtons;
+
+	noInterrupts ();
+
+	// Nothing pressed, MegaDrive uses the LOW state for pressed buttons
+	for (byte i = 0; i < sizeof (mdTable); ++i)
+		mdTable[i] = MD_OUTMASK;
+	mdStep = 0;
+	mdNext = MD_OUTMASK;
+	mdSlot = false;
+
+	MD_OUTPORT = MD_OUTMASK;
+	MD_OUTDIR |= MD_OUTMASK;
+	MD_SELECT_DIR &= ~(1 << MD_SELECT_BIT);
+
+	/* The millis() ISR takes ~5 us, if SELECT changes while it's running we
+	 * are way too late
+	 */
+	TIMSK0 &= ~(1 << TOIE0);
+
+	// Timer 2: Normal mode, prescaler = 1024, compare match A at the timeout
+	TCCR2A = 0;
+	TCCR2B = (1 << CS22) | (1 << CS21) | (1 << CS20);
+	OCR2A = US_TO_T2TICKS (TIMEOUT_US);
+	TCNT2 = 0;
+	TIFR2 = (1 << OCF2A) | (1 << TOV2);
+	TIMSK2 = (1 << OCIE2A);
+
+	mdPrepareInterrupt ();
+	mdEnableInterrupt ();
+
+	interrupts ();
+}
+
+void MegaDriveOutput::setButtons (uint16_t buttons) {
+	// MegaDrive uses the LOW state to indicate that a button is pressed
+	byte high = MD_OUTMASK
+	          & ~((buttons & MD_UP) ? (1 << 0) : 0)
+	          & ~((buttons & MD_DOWN) ? (1 << 1) : 0)
+	          & ~((buttons & MD_LEFT) ? (1 << 2) : 0)
+	          & ~((buttons & MD_RIGHT) ? (1 << 3) : 0)
+	          & ~((buttons & MD_B) ? (1 << 4) : 0)
+	          & ~((buttons & MD_C) ? (1 << 5) : 0)
+	          ;
+
+	// Left and Right are always LOW here, that's how the pad is detected
+	byte low = (MD_OUTMASK & ~((1 << 2) | (1 << 3)))
+	         & ~((buttons & MD_UP) ? (1 << 0) : 0)
+	         & ~((buttons & MD_DOWN) ? (1 << 1) : 0)
+	         & ~((buttons & MD_A) ? (1 << 4) : 0)
+	         & ~((buttons & MD_START) ? (1 << 5) : 0)
+	         ;
+
+	byte tbl[8] = {high, low, high, low, high, low, high, low};
+	if (sixButtons) {
+		tbl[5] = low & ~((1 << 0) | (1 << 1));
+		tbl[6] = high | 0x0F;
+		tbl[6] &= ~((buttons & MD_Z) ? (1 << 0) : 0)
+		        & ~((buttons & MD_Y) ? (1 << 1) : 0)
+		        & ~((buttons & MD_X) ? (1 << 2) : 0)
+		        & ~((buttons & MD_MODE) ? (1 << 3) : 0)
+		        ;
+		tbl[7] = low | 0x0F;
+	}
+
+	/* The ISR might pick up a mix of old and new entries, but each of them is
+	 * consistent on its own, so that's harmless. Interrupts only need to be
+	 * disabled to update what is currently being output.
+	 */
+	for (byte i = 0; i < sizeof (tbl); ++i)
+		mdTable[i] = tbl[i];
+
+	noInterrupts ();
+	byte step = mdStep;
+	MD_OUTPORT = tbl[step];
+	mdNext = tbl[(step + 1) & 0x07];
+	interrupts ();
+}
+
+boolean MegaDriveOutput::canPoll () {
+	boolean ret = false;
+
+	byte t = TCNT2;
+	if (mdSlot) {
+		mdSlot = false;
+		ret = t >= OCR2A && t < OCR2A + US_TO_T2TICKS (SLOT_LENGTH_US);
+	}
+
+	return ret;
+}
+
+#endif
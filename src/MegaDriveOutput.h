@@ -0,0 +1,220 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * MegaDrive/Genesis 3- and 6-button pad emulation, see:
+ * - https://www.plutiedev.com/controllers
+ * - https://segaretro.org/Six_Button_Control_Pad_(Mega_Drive)
+ */
+
+#ifndef MEGADRIVEOUTPUT_INCLUDED
+#define MEGADRIVEOUTPUT_INCLUDED
+
+#include <Arduino.h>
+#include "output/mdpinconfig.h"
+
+#ifndef MEGADRIVE_OUTPUT_SUPPORTED
+#error "MegaDriveOutput is not currently supported on this platform"
+#endif
+
+/* Makes an Arduino behave like a MegaDrive controller, with no external
+ * multiplexer.
+ *
+ * The console switches the SELECT line and reads the data lines a couple of us
+ * later, which is much less than the time it takes us to poll a N64/GC
+ * controller. So SELECT is handled by an interrupt which just copies a
+ * precomputed byte to the output port, and controller polls are confined to
+ * the long quiet period between two console reads, see canPoll().
+ *
+ * Counting cycles (this was not measured), the response comes at most 1 us (at
+ * 16 MHz) after a SELECT edge, but only if no other ISR is running at that
+ * moment, as AVR ISRs don't nest. Thus:
+ * - The millis() interrupt is disabled by begin(), so millis(), micros() and
+ *   delay() will no longer work. Timer 0 keeps running, though.
+ * - Timer 2 is used to implement the 6-button timeout and poll scheduling, so
+ *   tone() and anything else using it will not work. Its ISR only runs once
+ *   SELECT has been quiet for TIMEOUT_US, so it can only get in the way of a
+ *   console that starts reading right then.
+ * - A controller poll runs the receiver ISR for every bit of the reply, or
+ *   keeps interrupts disabled throughout with N64PAD_POLLING_RECEIVER. Either
+ *   delays the response by several us, so the bound only holds if the console
+ *   does not read during the poll slot plus the poll itself, see canPoll().
+ * - Any other interrupt you enable can delay the response by as long as its ISR
+ *   takes.
+ */
+class MegaDriveOutput {
+public:
+	enum MdButton {
+		MD_UP     = 1 << 0,
+		MD_DOWN   = 1 << 1,
+		MD_LEFT   = 1 << 2,
+		MD_RIGHT  = 1 << 3,
+		MD_A      = 1 << 4,
+		MD_B      = 1 << 5,
+		MD_C      = 1 << 6,
+		MD_START  = 1 << 7,
+		MD_X      = 1 << 8,
+		MD_Y      = 1 << 9,
+		MD_Z      = 1 << 10,
+		MD_MODE   = 1 << 11
+	};
+
+	/* Sets up pins, timers and interrupts. Only games that know about it will
+	 * read the extra buttons of a 6-button pad, but some older ones get
+	 * confused by it: set sixButtons to false for those.
+	 */
+	void begin (boolean sixButtons = true);
+
+	/* Updates the state reported to the console. Use MdButton values, 1 means
+	 * pressed.
+	 */
+	void setButtons (uint16_t buttons);
+
+	/* Returns true if a controller poll can be started right now without
+	 * getting in the way of the console.
+	 *
+	 * A slot is opened once the 6-button timeout has expired after a console
+	 * read (i.e.: right after the console is done) and lasts SLOT_LENGTH_US.
+	 * If the console is not reading the pad at all, a new slot is opened every
+	 * ~16 ms. This returns true at most once per slot.
+	 */
+	boolean canPoll ();
+
+private:
+	// 6-button pads reset their TH counter after ~1.5 ms of inactivity
+	static const unsigned int TIMEOUT_US = 1500;
+
+	// Any poll must be started this soon after the slot opens
+	static const unsigned int SLOT_LENGTH_US = 1000;
+
+	boolean sixButtons;
+};
+
+/* The ISRs are defined here rather than in the library, so that they only get
+ * linked into sketches which actually use MegaDriveOutput and do not clash
+ * with attachInterrupt(), tone() and friends in all the others. This means
+ * that this header must only be included from a single file of your sketch.
+ */
+#ifndef MEGADRIVEOUTPUT_NO_ISR
+
+// See MegaDriveOutput.cpp
+extern volatile byte mdTable[8];
+extern volatile byte mdStep;
+extern volatile byte mdNext;
+extern volatile boolean mdSlot;
+
+/* Called on every edge of SELECT. The console samples the data lines a couple
+ * of us after it switches SELECT, so the port byte for the new phase is always
+ * precomputed in mdNext and goes out before anything else. Counting the 4-cycle
+ * interrupt response, the jmp in the vector table and an instruction that
+ * might be completing, the port switches at most 16 cycles (1 us at 16 MHz)
+ * after the edge, as long as no other ISR is in the way.
+ */
+ISR (MD_SELECT_VECTOR, ISR_NAKED) {
+	__asm__ __volatile__ (
+		"push    r24\n\t"
+		"lds     r24, mdNext\n\t"
+		"out     %[outport], r24\n\t"
+
+		// Console has its data, now we can take our time
+		"in      r24, %[sreg]\n\t"
+		"push    r24\n\t"
+		"push    r25\n\t"
+		"push    r30\n\t"
+		"push    r31\n\t"
+
+		// Restart the 6-button timeout and close any pending poll slot
+		"clr     r24\n\t"
+		"sts     %[tcnt], r24\n\t"
+		"sts     mdSlot, r24\n\t"
+		"ldi     r24, %[tifrclr]\n\t"
+		"out     %[tifr], r24\n\t"
+
+		// Next step of the TH cycle
+		"lds     r24, mdStep\n\t"
+		"inc     r24\n\t"
+		"andi    r24, 0x07\n\t"
+
+		/* Even steps happen with SELECT high, odd ones with SELECT low. If the
+		 * two disagree we missed an edge, so fall back to the plain 3-button
+		 * step that matches the actual line level
+		 */
+		"sbis    %[inport], %[selbit]\n\t"
+		"rjmp    1f\n\t"
+		"sbrc    r24, 0\n\t"
+		"clr     r24\n\t"
+		"rjmp    2f\n\t"
+		"1:\n\t"
+		"sbrs    r24, 0\n\t"
+		"ldi     r24, 1\n\t"
+		"2:\n\t"
+		"sts     mdStep, r24\n\t"
+
+		// Output again, this only changes something if we just resynced
+		"ldi     r30, lo8(mdTable)\n\t"
+		"ldi     r31, hi8(mdTable)\n\t"
+		"add     r30, r24\n\t"
+		"clr     r25\n\t"
+		"adc     r31, r25\n\t"
+		"ld      r25, Z\n\t"
+		"out     %[outport], r25\n\t"
+
+		// Precompute the reply to the next edge
+		"inc     r24\n\t"
+		"andi    r24, 0x07\n\t"
+		"ldi     r30, lo8(mdTable)\n\t"
+		"ldi     r31, hi8(mdTable)\n\t"
+		"add     r30, r24\n\t"
+		"clr     r25\n\t"
+		"adc     r31, r25\n\t"
+		"ld      r25, Z\n\t"
+		"sts     mdNext, r25\n\t"
+
+		"pop     r31\n\t"
+		"pop     r30\n\t"
+		"pop     r25\n\t"
+		"pop     r24\n\t"
+		"out     %[sreg], r24\n\t"
+		"pop     r24\n\t"
+		"reti\n\t"
+		:
+		: [outport] "I" (_SFR_IO_ADDR (MD_OUTPORT)),
+		  [inport] "I" (_SFR_IO_ADDR (MD_SELECT_INPORT)),
+		  [selbit] "I" (MD_SELECT_BIT),
+		  [sreg] "I" (_SFR_IO_ADDR (SREG)),
+		  [tifr] "I" (_SFR_IO_ADDR (TIFR2)),
+		  [tifrclr] "M" ((1 << OCF2A) | (1 << TOV2)),
+		  [tcnt] "n" (_SFR_MEM_ADDR (TCNT2))
+	);
+}
+
+ISR (TIMER2_COMPA_vect) {
+	/* SELECT has been quiet for long enough, start over from the step matching
+	 * its current level. This also means the console is done reading, so we
+	 * can poll the controller.
+	 */
+	byte step = (MD_SELECT_INPORT & (1 << MD_SELECT_BIT)) ? 0 : 1;
+	mdStep = step;
+	MD_OUTPORT = mdTable[step];
+	mdNext = mdTable[step + 1];
+	mdSlot = true;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#include "N64Mouse.h"
+
+static const byte CMD_IDENTIFY = 0x00;
+static const byte CMD_POLL = 0x01;
+
+// Adds a delta to an accumulator, only clipping at the limits of the latter
+static int16_t accumulate (int16_t acc, int8_t delta) {
+	int32_t r = (int32_t) acc + delta;
+	return r < -32768 ? -32768 : (r > 32767 ? 32767 : r);
+}
+
+// Takes up to a report's worth out of an accumulator
+static int8_t take (int16_t& acc) {
+	int8_t ret = acc < -127 ? -127 : (acc > 127 ? 127 : acc);
+	acc -= ret;
+	return ret;
+}
+
+boolean N64Mouse::begin () {
+	proto.begin ();
+
+	buttons = 0;
+	dx = 0;
+	dy = 0;
+
+	// Controllers reply 0x05 here
+	return runCommand (CMD_IDENTIFY, 3) && buf[0] == 0x02;
+}
+
+boolean N64Mouse::read () {
+	/* Bit 6 of the second byte is never set, as on the controller. The
+	 * movement in a corrupted reply is lost even if the retry succeeds, but at
+	 * least the buttons will be right.
+	 */
+	boolean ret = proto.runPoll (&CMD_POLL, 1, buf, 4, 0x0040, 0x0000, *this);
+	if (ret) {
+		buttons = ((((uint16_t) buf[0]) << 8) | buf[1]);
+		dx = accumulate (dx, (int8_t) buf[2]);
+		dy = accumulate (dy, (int8_t) buf[3]);
+	}
+
+	return ret;
+}
+
+void N64Mouse::drain (int8_t& x, int8_t& y) {
+	x = take (dx);
+	y = take (dy);
+}
+
+boolean N64Mouse::runCommand (byte cmd, byte repsz) {
+	return proto.runCommand (&cmd, 1, buf, repsz);
+}
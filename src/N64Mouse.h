@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#ifndef N64MOUSE_INCLUDED
+#define N64MOUSE_INCLUDED
+
+#include "protocol/N64PadProtocol.h"
+
+/* The N64 mouse answers the same poll command as the controller, but in place
+ * of the stick position it reports how much it moved since the previous poll.
+ *
+ * So, unlike N64Pad, there is no minimum interval between polls: read() should
+ * be called as often as possible and it adds up movement, which is then taken
+ * out a HID report at a time with drain(). Nothing is lost no matter how often
+ * the two are called, as long as drain() is called at least once every few
+ * hundred polls.
+ *
+ * See PollStats for retries and corruptFrames.
+ */
+class N64Mouse: public PollStats {
+public:
+	enum MouseButton {
+		BTN_LEFT  = 1 << 15,		// A on the controller
+		BTN_RIGHT = 1 << 14			// B on the controller
+	};
+
+	// Button status register. Use MouseButton values to test this. 1 means pressed.
+	uint16_t buttons;
+
+	/* Movement accumulated since it was last drained, positive RIGHT/UP. This
+	 * only clips if nobody drains it for a long while, at 32767 counts.
+	 */
+	int16_t dx;
+	int16_t dy;
+
+	// This can also be called anytime to reset the mouse
+	boolean begin ();
+
+	/* Polls the mouse, adding its movement to dx/dy.
+	 *
+	 * Note that this functions disables interrupts and runs for 160+ us!
+	 */
+	boolean read ();
+
+	// Returns true if there is any movement waiting to be drained
+	boolean moved () const {
+		return dx != 0 || dy != 0;
+	}
+
+	/* Takes as much movement as fits in a single HID report (-127 to 127 per
+	 * axis) out of dx/dy, the rest is left for the next call
+	 */
+	void drain (int8_t& x, int8_t& y);
+
+private:
+	N64PadProtocol proto;
+
+	// 4 is enough for all our uses
+	byte buf[4];
+
+	boolean runCommand (byte cmd, byte repsz);
+};
+
+#endif
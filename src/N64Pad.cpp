@@ -59,8 +59,10 @@ boolean N64Pad::begin () {
 boolean N64Pad::read () {
 	boolean ret = true;
 	
-	if (millis () - last_poll >= MIN_POLL_INTERVAL_MS) {
-		if ((ret = (runCommand (CMD_POLL) != NULL))) {
+	if (pollDue ()) {
+		// Bit 6 of the second byte is never set
+		if ((ret = proto.runPoll (&(protoCommands[CMD_POLL][1]), 1, buf, protoCommands[CMD_POLL][0],
+								  0x0040, 0x0000, *this))) {
 			buttons = ((((uint16_t) buf[0]) << 8) | buf[1]);
 			x = (int8_t) buf[2];
 			y = (int8_t) buf[3];
@@ -19,9 +19,10 @@
 
 #include "protocol/N64PadProtocol.h"
 
-class N64Pad {
+// See PollStats and PollSchedule for the members they add
+class N64Pad: public PollStats, public PollSchedule {
 public:
-	const byte MIN_POLL_INTERVAL_MS = 1000U / 60U;
+	static const byte MIN_POLL_INTERVAL_MS = 1000U / 60U;
 
 	enum PadButton {
 		BTN_A       = 1 << 15,
@@ -33,7 +34,7 @@ public:
 		BTN_LEFT    = 1 << 9,
 		BTN_RIGHT   = 1 << 8,
 		BTN_LRSTART = 1 << 7,	// This is set when L+R+Start are pressed (and BTN_START is not)
-		/* Unused   = 1 << 6, */
+		/* Always 0 = 1 << 6, */
 		BTN_L       = 1 << 5,
 		BTN_R       = 1 << 4,
 		BTN_C_UP    = 1 << 3,
@@ -59,6 +60,8 @@ public:
 	 */
 	int8_t y;
 
+	N64Pad (): PollSchedule (MIN_POLL_INTERVAL_MS) {}
+
 	// This can also be called anytime to reset the controller
 	boolean begin ();
 
@@ -86,9 +89,6 @@ private:
 
 	// 4 is enough for all our uses
 	byte buf[4];
-
-	// millis() last time controller was polled
-	unsigned long last_poll;
 	
 	byte *runCommand (const ProtoCommand cmd);
 };
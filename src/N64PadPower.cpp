@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+// ISR is only wanted in the sketch, see N64PadPower.h
+#define N64PADPOWER_NO_ISR
+#include "N64PadPower.h"
+
+#if defined (__AVR_ATtiny25__) || defined (__AVR_ATtiny45__) || defined (__AVR_ATtiny85__)
+#define WDT_CONTROL WDTCR
+#else
+#define WDT_CONTROL WDTCSR
+
+// Defined in wiring.c, we need to compensate it for the time Timer 0 is stopped
+extern volatile unsigned long timer0_millis;
+#define COMPENSATE_MILLIS
+#endif
+
+volatile unsigned long powerWakeMicros;
+
+N64PadPower::Hook N64PadPower::hook = NULL;
+unsigned long N64PadPower::lastWake = 0;
+
+void N64PadPower::setHook (Hook _hook) {
+	hook = _hook;
+}
+
+void N64PadPower::powerDown (byte wdp) {
+	noInterrupts ();
+
+	// Watchdog in interrupt mode, no reset
+	wdt_reset ();
+	MCUSR &= ~(1 << WDRF);
+	WDT_CONTROL = (1 << WDCE) | (1 << WDE);
+	WDT_CONTROL = (1 << WDIE) | (wdp & 0x07) | ((wdp & 0x08) ? (1 << WDP3) : 0);
+
+	set_sleep_mode (SLEEP_MODE_PWR_DOWN);
+	sleep_enable ();
+#if defined (BODS) && defined (BODSE)
+	sleep_bod_disable ();
+#endif
+	interrupts ();
+	sleep_cpu ();
+
+	// Back from the watchdog ISR
+	sleep_disable ();
+	wdt_disable ();
+}
+
+void N64PadPower::sleep (unsigned long ms) {
+	N64PadPowerStats stats;
+
+	stats.activeUs = micros () - lastWake;
+	stats.asleepMs = 0;
+	stats.idleMs = 0;
+	stats.wakeUs = 0;
+
+	// Watchdog periods are 16 ms << wdp, up to 8 s
+	while (ms >= WDT_MIN_MS) {
+		byte wdp = 0;
+		while (wdp < 9 && ((unsigned long) WDT_MIN_MS << (wdp + 1)) <= ms)
+			++wdp;
+
+		unsigned int period = WDT_MIN_MS << wdp;
+		powerDown (wdp);
+		stats.wakeUs = micros () - powerWakeMicros;
+
+#ifdef COMPENSATE_MILLIS
+		noInterrupts ();
+		timer0_millis += period;
+		interrupts ();
+#endif
+
+		stats.asleepMs += period;
+		ms -= period;
+	}
+
+	// Less than a watchdog period left, Timer 0 will wake us up every ms
+	if (ms > 0) {
+		unsigned long start = millis ();
+		set_sleep_mode (SLEEP_MODE_IDLE);
+		while (millis () - start < ms)
+			sleep_mode ();
+		stats.idleMs = ms;
+	}
+
+	lastWake = micros ();
+
+	if (hook)
+		hook (stats);
+}
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#ifndef N64PADPOWER_INCLUDED
+#define N64PADPOWER_INCLUDED
+
+#include <Arduino.h>
+
+/* What happened during the last call to N64PadPower::sleep(). Together with the
+ * figures from the datasheet (or better, your multimeter) for the active, idle
+ * and power-down supply currents, this gives the charge spent per poll:
+ *
+ *   Q = I_active * activeUs + I_powerdown * asleepMs + I_idle * idleMs
+ */
+struct N64PadPowerStats {
+	// Time spent awake since the previous call returned, in us
+	unsigned long activeUs;
+
+	// Time spent in power-down mode, in ms (nominal, the watchdog is +/- 10%)
+	unsigned int asleepMs;
+
+	// Time spent in idle mode, in ms
+	unsigned int idleMs;
+
+	/* Time from the last watchdog interrupt to returning to the caller, in us.
+	 * On top of this, the oscillator start-up time selected by the fuses
+	 * applies (16K cycles, i.e.: ~1 ms at 16 MHz on a stock Uno).
+	 */
+	unsigned int wakeUs;
+};
+
+/* Low-power waiting between controller polls, for battery-powered builds:
+ *
+ *   pad.read ();
+ *   // ... Use pad state ...
+ *   N64PadPower::sleep (pad.timeToNextPoll ());
+ *
+ * The CPU is put in power-down mode in steps of 16 ms and more, timed by the
+ * watchdog, and in idle mode for whatever is left. millis() is advanced by the
+ * time spent in power-down, except on the ATtinyX5.
+ *
+ * Note that power-down also stops the USB peripheral, so this is of little use
+ * on the Leonardo/Micro and Digispark, unless USB is not being used.
+ *
+ * To save power while waiting for the controller to reply, see
+ * N64PAD_SLEEP_WHILE_WAITING in pinconfig.h.
+ */
+class N64PadPower {
+public:
+	// Called every time sleep() returns
+	typedef void (*Hook) (const N64PadPowerStats& stats);
+
+	static void setHook (Hook hook);
+
+	// Sleeps for about ms milliseconds
+	static void sleep (unsigned long ms);
+
+private:
+	// Shortest watchdog period
+	static const byte WDT_MIN_MS = 16;
+
+	static Hook hook;
+
+	// micros() last time sleep() returned
+	static unsigned long lastWake;
+
+	static void powerDown (byte wdp);
+};
+
+/* As with MegaDriveOutput, the ISR is defined here so that it only gets linked
+ * into sketches which actually use N64PadPower and does not clash with other
+ * libraries using the watchdog. This header must only be included from a
+ * single file of your sketch.
+ */
+#ifndef N64PADPOWER_NO_ISR
+
+// See N64PadPower.cpp
+extern volatile unsigned long powerWakeMicros;
+
+ISR (WDT_vect) {
+	powerWakeMicros = micros ();
+}
+
+#endif
+
+#endif
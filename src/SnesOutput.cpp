@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#include <Arduino.h>
+#include "output/snespinconfig.h"
+
+#ifdef SNES_OUTPUT_SUPPORTED
+
+// ISRs are only wanted in the sketch, see SnesOutput.h
+#define SNESOUTPUT_NO_ISR
+#include "SnesOutput.h"
+
+// Timer 2 runs with a prescaler of 64, i.e.: 4 us per tick at 16 MHz
+#define US_TO_T2TICKS(us) ((us) * (F_CPU / 1000000UL) / 64UL)
+
+/* Report as shifted out, LSB first. Lines are active LOW, so 1 means not
+ * pressed. The last 4 bits of a SNES report are the controller ID and are
+ * always high for a standard pad.
+ */
+volatile byte snesReport[2] = {0xFF, 0xFF};
+
+// Length of the report in bytes, 2 for SNES, 1 for NES
+volatile byte snesLen;
+
+// Index of the next byte to be loaded into SPDR
+volatile byte snesByte;
+
+// Set when a controller poll slot is open
+volatile boolean snesSlot;
+
+void SnesOutput::begin (boolean _nes) {
+	nes = _nes;
+	last_poll = 0;
+
+	noInterrupts ();
+
+	snesReport[0] = 0xFF;
+	snesReport[1] = 0xFF;
+	snesLen = nes ? 1 : 2;
+	snesByte = snesLen + 1;
+	snesSlot = false;
+
+	SNES_LATCH_DIR &= ~(1 << SNES_LATCH_BIT);
+	SNES_SPI_DIR &= ~((1 << SNES_SS_BIT) | (1 << SNES_SCK_BIT));
+	SNES_SPI_DIR |= (1 << SNES_MISO_BIT);
+
+	// Slave, mode 2 (CPOL = 1, CPHA = 0), LSB first, interrupt enabled
+	SPCR = (1 << SPE) | (1 << SPIE) | (1 << DORD) | (1 << CPOL);
+	SPDR = 0xFF;
+
+	/* Timer 2: Normal mode, prescaler = 64, compare match A at the read
+	 * timeout. The interrupt is only enabled by LATCH.
+	 */
+	TCCR2A = 0;
+	TCCR2B = (1 << CS22);
+	OCR2A = US_TO_T2TICKS (READ_TIMEOUT_US);
+	TIMSK2 = 0;
+
+	snesPrepareInterrupt ();
+	snesEnableInterrupt ();
+
+	interrupts ();
+}
+
+void SnesOutput::setButtons (uint16_t buttons) {
+	if (nes) {
+		byte b = (buttons & 0xFC)
+		       | ((buttons & SNES_A) ? (1 << 0) : 0)
+		       | ((buttons & SNES_B) ? (1 << 1) : 0)
+		       ;
+		snesReport[0] = ~b;
+	} else {
+		/* Polls happen between two console reads, so there is no need to
+		 * update the two bytes atomically
+		 */
+		snesReport[0] = ~((byte) buttons);
+		snesReport[1] = ~((byte) (buttons >> 8) & 0x0F);
+	}
+}
+
+boolean SnesOutput::canPoll () {
+	boolean ret = false;
+
+	if (snesSlot) {
+		snesSlot = false;
+		ret = true;
+	} else if (millis () - last_poll >= IDLE_POLL_INTERVAL_MS) {
+		// Console does not seem to be there
+		ret = true;
+	}
+
+	if (ret)
+		last_poll = millis ();
+
+	return ret;
+}
+
+#endif
@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ *******************************************************************************
+ *
+ * SNES/NES controller reference:
+ * - https://www.repairfaq.org/REPAIR/F_SNES.html
+ * - https://www.nesdev.org/wiki/Standard_controller
+ */
+
+#ifndef SNESOUTPUT_INCLUDED
+#define SNESOUTPUT_INCLUDED
+
+#include <Arduino.h>
+#include "output/snespinconfig.h"
+
+#ifndef SNES_OUTPUT_SUPPORTED
+#error "SnesOutput is not currently supported on this platform"
+#endif
+
+/* Makes an Arduino behave like a SNES or NES controller.
+ *
+ * The console pulses LATCH and then clocks out 16 (SNES) or 8 (NES) bits at
+ * 12 us per bit, which we can't follow by bit-banging while a N64/GC controller
+ * poll is running. Instead, the SPI peripheral is run in slave mode (CPOL = 1,
+ * CPHA = 0, LSB first) and does the shifting in hardware: the report is
+ * preloaded into SPDR on LATCH and the SPI interrupt refills it with the second
+ * byte, which must happen within 6 us.
+ *
+ * To guarantee that, the millis() interrupt is masked from LATCH until the
+ * console has read all of its bits (~200 us, so no ticks are lost) and
+ * controller polls are confined to the period between two console reads, see
+ * canPoll(). Any other interrupt you enable might still get in the way.
+ *
+ * Consoles that read fewer bits than expected (i.e.: a NES with SnesOutput in
+ * SNES mode, or games that only read part of the report) would keep the
+ * millis() interrupt masked forever, so Timer 2 ends the read anyway
+ * READ_TIMEOUT_US after LATCH. This means Timer 2 can't be used for anything
+ * else (i.e.: tone()).
+ */
+class SnesOutput {
+public:
+	enum SnesButton {
+		SNES_B      = 1 << 0,
+		SNES_Y      = 1 << 1,
+		SNES_SELECT = 1 << 2,
+		SNES_START  = 1 << 3,
+		SNES_UP     = 1 << 4,
+		SNES_DOWN   = 1 << 5,
+		SNES_LEFT   = 1 << 6,
+		SNES_RIGHT  = 1 << 7,
+		SNES_A      = 1 << 8,
+		SNES_X      = 1 << 9,
+		SNES_L      = 1 << 10,
+		SNES_R      = 1 << 11
+	};
+
+	/* Sets up pins, SPI and interrupts. If nes is true, only 8 bits are
+	 * reported, in NES order (A, B, Select, Start, Up, Down, Left, Right).
+	 */
+	void begin (boolean nes = false);
+
+	/* Updates the state reported to the console. Use SnesButton values, 1
+	 * means pressed. In NES mode X, Y, L and R are ignored.
+	 */
+	void setButtons (uint16_t buttons);
+
+	/* Returns true if a controller poll can be started right now without
+	 * getting in the way of the console.
+	 *
+	 * This happens once after every console read, or every
+	 * IDLE_POLL_INTERVAL_MS if the console is not reading the controller at
+	 * all.
+	 */
+	boolean canPoll ();
+
+private:
+	static const byte IDLE_POLL_INTERVAL_MS = 100;
+
+	// Longest a console read can take, a full SNES one is ~210 us
+	static const unsigned int READ_TIMEOUT_US = 300;
+
+	boolean nes;
+
+	// millis() last time canPoll() returned true
+	unsigned long last_poll;
+};
+
+/* As with MegaDriveOutput, ISRs are defined here so that they only get linked
+ * into sketches which actually use SnesOutput. This header must only be
+ * included from a single file of your sketch.
+ */
+#ifndef SNESOUTPUT_NO_ISR
+
+// See SnesOutput.cpp
+extern volatile byte snesReport[2];
+extern volatile byte snesLen;
+extern volatile byte snesByte;
+extern volatile boolean snesSlot;
+
+ISR (SNES_LATCH_VECTOR) {
+	/* SS is high as long as LATCH is, so this goes straight into the shift
+	 * register and the first bit is presented as soon as LATCH goes low
+	 */
+	SPDR = snesReport[0];
+	snesByte = 1;
+	snesSlot = false;
+
+	// The millis() ISR is long enough to make us miss a refill
+	TIMSK0 &= ~(1 << TOIE0);
+
+	// But don't wait forever for the console to finish, see TIMER2_COMPA_vect
+	TCNT2 = 0;
+	TIFR2 = (1 << OCF2A);
+	TIMSK2 = (1 << OCIE2A);
+}
+
+ISR (SPI_STC_vect) {
+	/* We have about 6 us from the last rising edge of CLOCK to get the next
+	 * byte in. Once the report is over, the serial input of the shift register
+	 * in a real controller is grounded, so the line stays LOW. The console
+	 * inverts it and reads 1s (i.e.: "pressed"), but what we must put on the
+	 * line is 0 bits.
+	 */
+	byte i = snesByte;
+	if (i < snesLen) {
+		SPDR = snesReport[i];
+		snesByte = i + 1;
+	} else {
+		SPDR = 0x00;
+		if (i == snesLen) {
+			// Console is done, a pending millis() tick will be served now
+			TIMSK0 |= (1 << TOIE0);
+			TIMSK2 = 0;
+			snesSlot = true;
+			snesByte = i + 1;
+		}
+	}
+}
+
+ISR (TIMER2_COMPA_vect) {
+	/* The console stopped reading before the end of the report, consider it
+	 * done. Bits it might still clock get the same padding as above.
+	 */
+	TIMSK2 = 0;
+	TIMSK0 |= (1 << TOIE0);
+	snesByte = snesLen + 1;
+	snesSlot = true;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,54 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+// NOTE: This file is included both from C and assembly code!
+
+#if defined(__AVR_ATmega328P__) || defined (__AVR_ATmega328__) || defined (__AVR_ATmega168__)
+	// Arduino Uno, Nano, Pro Mini
+
+	/* SELECT (MegaDrive Pad Port Pin 7) on Pin 2, INT0. The interrupt must
+	 * trigger on both edges and must have a higher priority than the one used
+	 * by the controller (INT1 by default, see pinconfig.h).
+	 */
+	#define MD_SELECT_DIR DDRD
+	#define MD_SELECT_INPORT PIND
+	#define MD_SELECT_BIT PD2
+	#define MD_SELECT_VECTOR INT0_vect
+	#define mdPrepareInterrupt() {EICRA |= (1 << ISC00); EICRA &= ~(1 << ISC01);}
+	#define mdEnableInterrupt() {EIFR |= (1 << INTF0); EIMSK |= (1 << INT0);}
+	#define mdDisableInterrupt() {EIMSK &= ~(1 << INT0);}
+
+	/* All six data lines must live on a single port, so that they can be
+	 * switched with a single OUT instruction. Pins 8-13 are used, in this
+	 * order:
+	 * - PB0: Pad Port Pin 1 (Up/Z)
+	 * - PB1: Pad Port Pin 2 (Down/Y)
+	 * - PB2: Pad Port Pin 3 (Left/X)
+	 * - PB3: Pad Port Pin 4 (Right/Mode)
+	 * - PB4: Pad Port Pin 6 (A/B)
+	 * - PB5: Pad Port Pin 9 (Start/C)
+	 *
+	 * PB6 and PB7 are taken by the crystal, so we can write the whole port.
+	 */
+	#define MD_OUTDIR DDRB
+	#define MD_OUTPORT PORTB
+	#define MD_OUTMASK 0x3F
+
+	#define MEGADRIVE_OUTPUT_SUPPORTED
+#endif
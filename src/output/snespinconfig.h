@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * This file is part of N64Pad for Arduino.                                    *
+ *                                                                             *
+ * Copyright (C) 2015-2021 by SukkoPera                                        *
+ *                                                                             *
+ * N64Pad is free software: you can redistribute it and/or modify              *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * N64Pad is distributed in the hope that it will be useful,                   *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with N64Pad. If not, see <http://www.gnu.org/licenses/>.              *
+ ******************************************************************************/
+
+#if defined(__AVR_ATmega328P__) || defined (__AVR_ATmega328__) || defined (__AVR_ATmega168__)
+	// Arduino Uno, Nano, Pro Mini
+
+	/* LATCH (SNES Pad Port Pin 3) must go BOTH to Pin 2, INT0, which is used
+	 * to preload the report, and to Pin 10, SS, which resets the SPI shift
+	 * logic while LATCH is high and enables it when it goes low.
+	 */
+	#define SNES_LATCH_DIR DDRD
+	#define SNES_LATCH_BIT PD2
+	#define SNES_LATCH_VECTOR INT0_vect
+	#define snesPrepareInterrupt() {EICRA |= (1 << ISC01) | (1 << ISC00);}
+	#define snesEnableInterrupt() {EIFR |= (1 << INTF0); EIMSK |= (1 << INT0);}
+	#define snesDisableInterrupt() {EIMSK &= ~(1 << INT0);}
+
+	/* The rest is fixed by the SPI peripheral:
+	 * - Pin 10, SS: LATCH (see above)
+	 * - Pin 12, MISO: DATA (SNES Pad Port Pin 4)
+	 * - Pin 13, SCK: CLOCK (SNES Pad Port Pin 2)
+	 */
+	#define SNES_SPI_DIR DDRB
+	#define SNES_SS_BIT PB2
+	#define SNES_MISO_BIT PB4
+	#define SNES_SCK_BIT PB5
+
+	#define SNES_OUTPUT_SUPPORTED
+#endif
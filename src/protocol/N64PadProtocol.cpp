@@ -33,6 +33,12 @@
 // This can be enabled, but does not seem necessary
 //~ #define DISABLE_USART
 //~ #define DISABLE_MILLIS
+
+/* Time out reads by looking at the Timer 0 counter directly rather than at
+ * micros(): it's cheaper and it keeps working when the millis() interrupt is
+ * masked, as MegaDriveOutput does
+ */
+#define TIMEOUT_ON_TCNT0
 #elif defined ( __AVR_ATmega32U4__)
 // These are absolutely necessary for reliable readings
 #define DISABLE_USB_INTERRUPTS
@@ -50,15 +56,35 @@ UsbPause usbMagic;
 #include "N64PadProtocol.h"
 #include "pinconfig.h"
 
+#ifdef N64PAD_SLEEP_WHILE_WAITING
+#ifndef DISABLE_MILLIS
+#error "N64PAD_SLEEP_WHILE_WAITING requires DISABLE_MILLIS"
+#endif
+#include <avr/sleep.h>
+#endif
+
 /* A read will be considered failed if it hasn't completed within this amount of
  * microseconds. The N64/GC protocol takes 4us per bit. The longest command
- * reply we support is GC's poll command which returns 8 bytes, so this must be
- * at least 8 * 8 * 4 = 256 us plus some margin. Note that this is only used
- * when DISABLE_MILLIS is NOT defined, when it is a hw timer is used, which is
- * initialized in begin(), so if you change this make sure to tune the value
- * there accordingly, too.
+ * replies we support are GC's origin and recalibrate commands which return 10
+ * bytes, so this must be at least 10 * 8 * 4 = 320 us plus some margin. Note
+ * that this is only used when DISABLE_MILLIS is NOT defined, when it is a hw
+ * timer is used, which is initialized in begin(), so if you change this make
+ * sure to tune the value there accordingly, too.
  */
-#define COMMAND_TIMEOUT 300
+#define COMMAND_TIMEOUT 400
+
+/* Same as above, in Timer 0 ticks. The Arduino core always runs Timer 0 with a
+ * prescaler of 64, so this is 100 at 16 MHz and must stay below 256.
+ */
+#define COMMAND_TIMEOUT_TICKS ((COMMAND_TIMEOUT * (F_CPU / 1000000UL)) / 64)
+
+/* Every reply ends with a stop bit, whose falling edge comes about 3 us after
+ * the last data bit has been sampled. A reply without one is not trusted, as
+ * it means we got out of sync with the controller somewhere. This is how long
+ * we wait for it, in us (roughly, as delayMicroseconds() is not that precise
+ * at 1 us).
+ */
+#define STOP_BIT_TIMEOUT 16
 
 // Delay 62.5ns on a 16MHz AtMega
 #define NOP __asm__ __volatile__ ("nop\n\t")
@@ -87,7 +113,16 @@ UsbPause usbMagic;
 	delay2us(); \
 } while (0)
 
-byte repbuf2[8];
+#ifdef N64PAD_POLLING_RECEIVER
+// See polling.S
+extern "C" byte n64padReceive (byte *buf, byte len);
+
+// Set in the value returned by the above when the stop bit was seen
+#define RECEIVE_STOP_BIT 0x80
+#endif
+
+// Must be large enough for the longest reply we support
+byte repbuf2[10];
 static volatile byte *curByte = &GPIOR2;
 static volatile byte *curBit = &GPIOR1;
 
@@ -100,11 +135,13 @@ ISR (TIMER1_COMPA_vect) {
 #endif
 
 void N64PadProtocol::begin () {
+#ifndef N64PAD_POLLING_RECEIVER
 	// Prepare interrupts: INT0 is triggered by pin 2 FALLING
 	noInterrupts ();
 	prepareInterrupt ();
 	interrupts ();
 	// Do not enable interrupt here!
+#endif
 
 #ifdef DISABLE_MILLIS
 	/* Since we disable the timer interrupt we need some other way to trigger a
@@ -114,7 +151,7 @@ void N64PadProtocol::begin () {
 	TCCR1B = 0;
 	TCCR1B |= (1 << WGM12);					// Clear Timer on Compare (CTC)
 	TCCR1B |= (1 << CS10);					// Prescaler = 1
-	OCR1A = 4799;							// 16000000/((4799+1)*1) => 3333Hz/300us
+	OCR1A = 6399;							// 16000000/((6399+1)*1) => 2500Hz/400us
 #endif
 
 	// Signalling output
@@ -200,6 +237,7 @@ boolean N64PadProtocol::runCommand (const byte *cmdbuf, const byte cmdsz, byte *
 	// Prepare things for the INT0 ISR
 	*curBit = 8;
 	*curByte = 0;
+	boolean stopBit = false;
 
 	// Disable "things happening in the background" as needed
 #ifdef DISABLE_MILLIS
@@ -208,6 +246,10 @@ boolean N64PadProtocol::runCommand (const byte *cmdbuf, const byte cmdsz, byte *
 	TIMSK0 &= ~((1 << OCIE0B) | (1 << OCIE0A) | (1 << TOIE0));
 	TIFR0 |= (1 << OCF0B) | (1 << OCF0A) | (1 << TOV0);
 	interrupts ();
+#elif defined (N64PAD_POLLING_RECEIVER)
+	// The receiver has its own timeout
+#elif defined (TIMEOUT_ON_TCNT0)
+	byte start = TCNT0;
 #else
 	unsigned long start = micros ();
 #endif
@@ -229,11 +271,32 @@ boolean N64PadProtocol::runCommand (const byte *cmdbuf, const byte cmdsz, byte *
 #endif
 #endif
 
+#ifdef N64PAD_POLLING_RECEIVER
+	/* Nothing must get in the way from the first bit we send to the last one
+	 * we receive
+	 */
+	noInterrupts ();
+	sendCmd (cmdbuf, cmdsz);
+	byte received = n64padReceive (repbuf2, repsz);
+	interrupts ();
+
+	*curByte = received & ~RECEIVE_STOP_BIT;
+	stopBit = (received & RECEIVE_STOP_BIT) != 0;
+
+#ifdef DISABLE_MILLIS
+	TIMSK0 = oldTIMSK0;
+#endif
+#else
 #ifdef DISABLE_MILLIS
 	// Start timeout timer
 	startTimer ();
 #endif
 
+#ifdef N64PAD_SLEEP_WHILE_WAITING
+	set_sleep_mode (SLEEP_MODE_IDLE);
+	sleep_enable ();
+#endif
+
 	// We can send the command now
 	sendCmd (cmdbuf, cmdsz);
 
@@ -241,14 +304,46 @@ boolean N64PadProtocol::runCommand (const byte *cmdbuf, const byte cmdsz, byte *
 	enableInterrupt ();
 
 	// OK, just wait for the reply buffer to fill at last
-	while (*curByte < repsz
-#ifndef DISABLE_MILLIS
-		&& micros () - start <= COMMAND_TIMEOUT
+#ifdef N64PAD_SLEEP_WHILE_WAITING
+	/* Edges come every 4 us and the ISR is done well before the next one, so
+	 * we are always back to sleep in time not to miss it. Only the Timer 1 ISR
+	 * can wake us up if the controller stops talking, so we must not check the
+	 * condition, have that ISR fire and then go to sleep with nothing left to
+	 * wake us up. Thus the check is done with interrupts disabled, and the
+	 * instruction after sei() is always run before any pending interrupt, so
+	 * we are asleep by the time it's served. An edge coming during the check
+	 * is served a few cycles late, which is still well within the bit.
+	 */
+	cli ();
+	while (*curByte < repsz && !timeout) {
+		sei ();
+		sleep_cpu ();
+		cli ();
+	}
+	sei ();
+
+	sleep_disable ();
 #else
+	while (*curByte < repsz
+#if defined (DISABLE_MILLIS)
 		&& !timeout
+#elif defined (TIMEOUT_ON_TCNT0)
+		&& (byte) (TCNT0 - start) <= COMMAND_TIMEOUT_TICKS
+#else
+		&& micros () - start <= COMMAND_TIMEOUT
 #endif
 	)
 	;
+#endif
+
+	/* The ISR is still enabled, so the stop bit will be taken as the first bit
+	 * of an extra byte
+	 */
+	if (*curByte == repsz) {
+		for (byte i = 0; i < STOP_BIT_TIMEOUT && *curBit == 8; ++i)
+			delayMicroseconds (1);
+		stopBit = *curBit != 8;
+	}
 
 	// Done, ISRs are no longer needed
 #ifdef DISABLE_MILLIS
@@ -256,6 +351,7 @@ boolean N64PadProtocol::runCommand (const byte *cmdbuf, const byte cmdsz, byte *
 	TIMSK0 = oldTIMSK0;
 #endif
 	disableInterrupt ();
+#endif
 
 	// Reenable things happening in background
 #ifdef DISABLE_USB_INTERRUPTS
@@ -275,5 +371,37 @@ boolean N64PadProtocol::runCommand (const byte *cmdbuf, const byte cmdsz, byte *
 	// FIXME
 	memcpy (repbuf, repbuf2, *curByte);
 
-	return *curByte == repsz;
+	return *curByte == repsz && stopBit;
+}
+
+boolean N64PadProtocol::runPoll (const byte *cmdbuf, const byte cmdsz, byte *repbuf, byte repsz,
+								 uint16_t fixedMask, uint16_t fixedBits, PollStats& stats) {
+	boolean ret = false;
+
+	for (byte i = 0; !ret && i < 2; ++i) {
+		if (i > 0)
+			++stats.retries;
+
+		if (runCommand (cmdbuf, cmdsz, repbuf, repsz)) {
+			uint16_t fixed = ((((uint16_t) repbuf[0]) << 8) | repbuf[1]) & fixedMask;
+			if (fixed == fixedBits) {
+				ret = true;
+			} else {
+				++stats.corruptFrames;
+			}
+		}
+	}
+
+	return ret;
+}
+
+unsigned long PollSchedule::timeToNextPoll () const {
+	unsigned long ret = 0;
+
+	unsigned long elapsed = millis () - last_poll;
+	if (last_poll != 0 && elapsed < pollInterval) {
+		ret = pollInterval - elapsed;
+	}
+
+	return ret;
 }
@@ -22,6 +22,48 @@
 
 #include <Arduino.h>
 
+/* Polls that had to be repeated because the first reply was missing,
+ * incomplete or corrupted, and replies that were corrupted, i.e.: broke bits
+ * that are fixed by the protocol, see N64PadProtocol::runPoll(). Every device
+ * class has these.
+ */
+struct PollStats {
+	unsigned int retries;
+	unsigned int corruptFrames;
+
+	PollStats (): retries (0), corruptFrames (0) {}
+};
+
+/* Keeps read() from polling a device more often than needed. Every device class
+ * with a read() has this.
+ */
+class PollSchedule {
+public:
+	/* Minimum time between two actual polls of the device, in ms. If read()
+	 * is called more often than this, it just keeps the last state.
+	 *
+	 * Set this to 0 if polls are scheduled externally (i.e.: by
+	 * MegaDriveOutput, which stops millis()).
+	 */
+	byte pollInterval;
+
+	/* Returns how many ms are left before read() will actually poll the
+	 * device again, which is how long we can sleep, see N64PadPower.
+	 */
+	unsigned long timeToNextPoll () const;
+
+protected:
+	// millis() last time the device was polled, 0 if never
+	unsigned long last_poll;
+
+	PollSchedule (byte interval): pollInterval (interval), last_poll (0) {}
+
+	// Returns true if read() should actually poll the device now
+	boolean pollDue () const {
+		return pollInterval == 0 || last_poll == 0 || millis () - last_poll >= pollInterval;
+	}
+};
+
 class N64PadProtocol {
 public:
 	void begin ();
@@ -31,6 +73,15 @@ public:
 	 */
 	boolean runCommand (const byte *cmdbuf, const byte cmdsz, byte *repbuf, byte repsz);
 
+	/* Same as above, for a poll command. The bits set in fixedMask must have
+	 * the value they have in fixedBits in the first two bytes of the reply
+	 * (MSB is the first byte). If anything goes wrong, the poll is repeated
+	 * once right away, so that a glitch on the line costs a retry rather than
+	 * a failed read(). What happens is counted in stats.
+	 */
+	boolean runPoll (const byte *cmdbuf, const byte cmdsz, byte *repbuf, byte repsz,
+					 uint16_t fixedMask, uint16_t fixedBits, PollStats& stats);
+
 	// Needs to be public as called from ISR
 	static void stopTimer ();
 
@@ -96,3 +96,24 @@
 	// At least for the moment...
 	#error "This library is not currently supported on this platform"
 #endif
+
+/* Uncomment to put the CPU in idle sleep while waiting for the controller to
+ * reply, rather than spinning at full power. Every edge on the data line and
+ * the read timeout wake it up. This requires the timeout to be implemented with
+ * Timer 1, i.e.: DISABLE_MILLIS must be defined in N64PadProtocol.cpp, as it is
+ * by default on the Leonardo.
+ */
+//~ #define N64PAD_SLEEP_WHILE_WAITING
+
+/* Uncomment to receive the controller reply with a cycle-counted loop that
+ * polls the data pin, rather than with an ISR per bit. Interrupts are disabled
+ * for the whole transaction (32 us per byte), but no interrupt is needed for
+ * the data pin, nothing can delay the sampling of a bit and the time a
+ * transaction takes is deterministic. This is useful on boards where other
+ * time-critical ISRs would compete with ours, like the Digispark.
+ */
+//~ #define N64PAD_POLLING_RECEIVER
+
+#if defined (N64PAD_POLLING_RECEIVER) && defined (N64PAD_SLEEP_WHILE_WAITING)
+	#error "N64PAD_SLEEP_WHILE_WAITING cannot be used with N64PAD_POLLING_RECEIVER"
+#endif